@@ -0,0 +1,178 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "AnchoredDiff.h"
+#include "NPDiff.h"
+#include "SimdKernels.h"
+
+
+AnchoredDiff::AnchoredDiff()
+{
+	fSequences = NULL;
+	fIDs[0] = fIDs[1] = NULL;
+}
+
+
+AnchoredDiff::~AnchoredDiff()
+{
+}
+
+
+void
+AnchoredDiff::Detect(const Sequences* sequences)
+{
+	fScript.Clear();
+	fScript.SetSink(GetSink());
+	_StartClock();
+	fSequences = sequences;
+	if (sequences == NULL)
+		return;
+
+	Region whole;
+	whole.begin0 = whole.begin1 = 0;
+	whole.end0 = sequences->GetLength(0);
+	whole.end1 = sequences->GetLength(1);
+
+	fIDs[0] = sequences->GetIDs(0);
+	fIDs[1] = sequences->GetIDs(1);
+	if (fIDs[0] == NULL || fIDs[1] == NULL) {
+		_Fallback(whole);
+		fScript.Flush();
+		return;
+	}
+
+	_Prepare(sequences->GetIDLimit());
+
+	// Regions are processed from a stack rather than recursively, so that
+	// deeply nested inputs cannot overflow the thread's stack. Items are
+	// pushed in reverse, which keeps the script in forward order.
+	Item item;
+	item.region = whole;
+	item.isMatch = false;
+	fStack.push_back(item);
+	while (!fStack.empty()) {
+		item = fStack.back();
+		fStack.pop_back();
+
+		const Region& region = item.region;
+		if (item.isMatch) {
+			fScript.Append(DiffOperation::NotChanged, region.begin0, region.begin1,
+				region.end0 - region.begin0, region.end1 - region.begin1);
+		} else
+			_DetectRegion(region);
+	}
+	fScript.Flush();
+}
+
+
+void
+AnchoredDiff::_Prepare(uint32_t idLimit)
+{
+	fCounts[0].assign(idLimit, 0);
+	fCounts[1].assign(idLimit, 0);
+	fPositions.assign(idLimit, -1);
+}
+
+
+void
+AnchoredDiff::_DetectRegion(const Region& fullRegion)
+{
+	Region region = fullRegion;
+	int length0 = region.end0 - region.begin0;
+	int length1 = region.end1 - region.begin1;
+	int minLength = (length0 < length1) ? length0 : length1;
+
+	int headCount = CountEqualPrefix(fIDs[0] + region.begin0, fIDs[1] + region.begin1,
+		minLength);
+	region.begin0 += headCount;
+	region.begin1 += headCount;
+	if (headCount > 0) {
+		fScript.Append(DiffOperation::NotChanged, fullRegion.begin0, fullRegion.begin1,
+			headCount, headCount);
+	}
+
+	minLength -= headCount;
+	int tailCount = CountEqualSuffix(fIDs[0] + region.end0 - minLength,
+		fIDs[1] + region.end1 - minLength, minLength);
+	region.end0 -= tailCount;
+	region.end1 -= tailCount;
+	if (region.end0 < fullRegion.end0) {
+		Item tail;
+		tail.region.begin0 = region.end0;
+		tail.region.end0 = fullRegion.end0;
+		tail.region.begin1 = region.end1;
+		tail.region.end1 = fullRegion.end1;
+		tail.isMatch = true;
+		fStack.push_back(tail);
+	}
+
+	if (region.begin0 == region.end0 || region.begin1 == region.end1) {
+		fScript.Append(DiffOperation::Deleted, region.begin0, region.begin1,
+			region.end0 - region.begin0, 0);
+		fScript.Append(DiffOperation::Inserted, region.end0, region.begin1, 0,
+			region.end1 - region.begin1);
+		return;
+	}
+
+	MatchVector matches;
+	if (!_FindMatches(region, matches) || matches.empty()) {
+		_Fallback(region);
+		return;
+	}
+
+	// push the last gap first
+	Item item;
+	int end0 = region.end0;
+	int end1 = region.end1;
+	int index;
+	for (index = matches.size() - 1; index >= 0; index--) {
+		const Match& match = matches[index];
+		item.region.begin0 = match.from0 + match.count;
+		item.region.end0 = end0;
+		item.region.begin1 = match.from1 + match.count;
+		item.region.end1 = end1;
+		item.isMatch = false;
+		if (item.region.begin0 < item.region.end0 || item.region.begin1 < item.region.end1)
+			fStack.push_back(item);
+
+		item.region.begin0 = match.from0;
+		item.region.end0 = match.from0 + match.count;
+		item.region.begin1 = match.from1;
+		item.region.end1 = match.from1 + match.count;
+		item.isMatch = true;
+		fStack.push_back(item);
+
+		end0 = match.from0;
+		end1 = match.from1;
+	}
+
+	item.region.begin0 = region.begin0;
+	item.region.end0 = end0;
+	item.region.begin1 = region.begin1;
+	item.region.end1 = end1;
+	item.isMatch = false;
+	if (item.region.begin0 < item.region.end0 || item.region.begin1 < item.region.end1)
+		fStack.push_back(item);
+}
+
+
+void
+AnchoredDiff::_Fallback(const Region& region)
+{
+	SubSequences window(fSequences, region.begin0, region.end0 - region.begin0,
+		region.begin1, region.end1 - region.begin1);
+	NPDiff diff;
+	_PassLimits(diff);
+	diff.Detect(&window);
+	if (diff.IsApproximate())
+		_SetApproximate();
+
+	const DiffOperation* operation;
+	int index;
+	for (index = 0; (operation = diff.GetOperationAt(index)) != NULL; index++) {
+		fScript.Append(operation->op, region.begin0 + operation->from0,
+			region.begin1 + operation->from1, operation->count0, operation->count1);
+	}
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef ANCHOREDDIFF_H
+#define ANCHOREDDIFF_H
+
+#include <vector>
+
+#include "DiffEngine.h"
+#include "DiffScript.h"
+
+
+/*
+ *	Base of the diff algorithms that split the sequences at matching runs of
+ *	elements they consider reliable, and recurse into the gaps between them.
+ *	Regions in which no such run is found are handed to NPDiff. Both
+ *	sequences must provide element IDs, otherwise NPDiff diffs them as a
+ *	whole.
+ */
+class AnchoredDiff : public DiffEngine {
+public:
+						AnchoredDiff();
+	virtual				~AnchoredDiff();
+
+	virtual	void			Detect(const Sequences* sequences);
+	virtual	const DiffOperation*	GetOperationAt(int index) const
+								{ return fScript.GetOperationAt(index); }
+
+	struct Match {
+		int		from0;
+		int		from1;
+		int		count;
+	};
+	typedef std::vector<Match>	MatchVector;
+
+protected:
+	struct Region {
+		int		begin0;
+		int		end0;
+		int		begin1;
+		int		end1;
+	};
+
+	// Fills matches with runs of equal elements inside the region, ordered
+	// and not overlapping on both sides. The region is not empty on either
+	// side and its first and last elements differ. Returns false if the
+	// region cannot be anchored.
+	virtual	bool		_FindMatches(const Region& region, MatchVector& matches) = 0;
+
+			void		_Prepare(uint32_t idLimit);
+
+protected:
+			const uint32_t*	fIDs[2];
+
+			// per ID scratch space, cleared again after each use
+			std::vector<uint32_t>	fCounts[2];
+			std::vector<int>		fPositions;
+
+private:
+	struct Item {
+		Region	region;
+		bool	isMatch;	//< region is a run of equal elements
+	};
+
+			void		_DetectRegion(const Region& region);
+			void		_Fallback(const Region& region);
+
+private:
+	const Sequences*	fSequences;
+			DiffScript	fScript;
+	std::vector<Item>	fStack;
+};
+
+#endif // ANCHOREDDIFF_H
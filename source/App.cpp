@@ -28,7 +28,10 @@
 #include "CommandIDs.h"
 #include "OpenFilesDialog.h"
 #include "DiffWindow.h"
+#include "LineIndexCache.h"
+#include "TextCache.h"
 #include "TextFileFilter.h"
+#include "ThreadPool.h"
 
 #undef B_TRANSLATION_CONTEXT
 #define B_TRANSLATION_CONTEXT "Application"
@@ -44,13 +47,20 @@ App::App()
 	fWindowCount = 0;
 	fOpenFilesPanel = NULL;
 	fSettings = NULL;
+	fLineIndexCache = NULL;
+	fThreadPool = new ThreadPool();
 
 	_LoadSettings();
+	_CreateLineIndexCache();
+	fTextCache = new TextCache(fLineIndexCache);
 }
 
 
 App::~App()
 {
+	delete fThreadPool;
+	delete fTextCache;
+	delete fLineIndexCache;
 }
 
 
@@ -258,6 +268,20 @@ App::_LoadSettings()
 }
 
 
+void
+App::_CreateLineIndexCache()
+{
+	BPath path;
+	if (find_directory(B_USER_SETTINGS_DIRECTORY, &path) != B_OK)
+		return;
+
+	BString cacheDirectory(B_TRANSLATE_SYSTEM_NAME("PonpokoDiff"));
+	cacheDirectory << "_line_indexes";
+	path.Append(cacheDirectory.String());
+	fLineIndexCache = new LineIndexCache(path.Path());
+}
+
+
 void
 App::_OpenFilesPanel(BMessage* message)
 {
@@ -17,7 +17,10 @@ extern const char *kAppSignature;
 
 
 class DiffWindow;
+class LineIndexCache;
 class OpenFilesDialog;
+class TextCache;
+class ThreadPool;
 
 
 class App : public BApplication {
@@ -29,6 +32,9 @@ public:
 			void			DiffWindowQuit(DiffWindow* window);
 			void			OpenFilesPanelClosed();
 
+			TextCache*		GetTextCache() const { return fTextCache; }
+			ThreadPool*		GetThreadPool() const { return fThreadPool; }
+
 public:
 	virtual	void			ReadyToRun();
 	virtual void			AboutRequested();
@@ -39,12 +45,16 @@ public:
 private:
 			void			_HelpWindow();
 			void			_LoadSettings();
+			void			_CreateLineIndexCache();
 			void			_OpenFilesPanel(BMessage* message);
 
 private:
 		BMessage*			fSettings;
 		int32				fWindowCount;
 		OpenFilesDialog*	fOpenFilesPanel;
+		LineIndexCache*		fLineIndexCache;
+		TextCache*			fTextCache;
+		ThreadPool*			fThreadPool;	//< one worker per CPU, for all windows
 };
 
 #endif // APP_H
@@ -22,6 +22,11 @@ enum
 	MSG_FILE_LAUNCH			= 'mLnc',
 	MSG_FILE_SWITCH			= 'mSwi',
 
+	MSG_ALGORITHM			= 'mAlg',
+
+	MSG_DIFF_PROGRESS		= 'dPrg',
+	MSG_DIFF_FINISHED		= 'dFin',
+
 	MSG_OPEN_LOCATION		= 'mLoc',
 	MSG_HELP				= 'mhlp',
 
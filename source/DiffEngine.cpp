@@ -0,0 +1,180 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "DiffEngine.h"
+#include "HistogramDiff.h"
+#include "NPDiff.h"
+#include "ParallelDiff.h"
+#include "PatienceDiff.h"
+
+#include <time.h>
+
+
+SubSequences::SubSequences(const Sequences* base, int begin0, int length0, int begin1,
+	int length1)
+{
+	fBase = base;
+	fBegin[0] = begin0;
+	fBegin[1] = begin1;
+	fLength[0] = length0;
+	fLength[1] = length1;
+}
+
+
+const uint32_t*
+SubSequences::GetIDs(int seqNo) const
+{
+	const uint32_t* ids = fBase->GetIDs(seqNo);
+	if (ids == NULL)
+		return NULL;
+	return ids + fBegin[seqNo];
+}
+
+
+DiffProgress::DiffProgress(int64_t reportInterval)
+{
+	pthread_mutex_init(&fLock, NULL);
+	fBytes = 0;
+	fRounds = 0;
+	fReportInterval = reportInterval;
+	fNextReport = 0;
+	fIsCanceled = false;
+}
+
+
+DiffProgress::~DiffProgress()
+{
+	pthread_mutex_destroy(&fLock);
+}
+
+
+void
+DiffProgress::Cancel()
+{
+	pthread_mutex_lock(&fLock);
+	fIsCanceled = true;
+	pthread_mutex_unlock(&fLock);
+}
+
+
+bool
+DiffProgress::IsCanceled()
+{
+	pthread_mutex_lock(&fLock);
+	bool canceled = fIsCanceled;
+	pthread_mutex_unlock(&fLock);
+	return canceled;
+}
+
+
+uint64_t
+DiffProgress::CountBytes()
+{
+	pthread_mutex_lock(&fLock);
+	uint64_t bytes = fBytes;
+	pthread_mutex_unlock(&fLock);
+	return bytes;
+}
+
+
+int64_t
+DiffProgress::CountRounds()
+{
+	pthread_mutex_lock(&fLock);
+	int64_t rounds = fRounds;
+	pthread_mutex_unlock(&fLock);
+	return rounds;
+}
+
+
+void
+DiffProgress::_Add(uint64_t bytes, int64_t rounds)
+{
+	int64_t now = DiffEngine::CurrentTime();
+
+	pthread_mutex_lock(&fLock);
+	fBytes += bytes;
+	fRounds += rounds;
+	bool report = now >= fNextReport;
+	if (report)
+		fNextReport = now + fReportInterval;
+	bytes = fBytes;
+	rounds = fRounds;
+	pthread_mutex_unlock(&fLock);
+
+	// outside the lock, so that Progressed() may take its time
+	if (report)
+		Progressed(bytes, rounds);
+}
+
+
+const size_t DiffEngine::kDefaultMemoryBudget = 64 * 1024 * 1024;
+
+
+DiffEngine::DiffEngine()
+{
+	fCostLimit = 0;
+	fTimeLimit = 0;
+	fMemoryBudget = kDefaultMemoryBudget;
+	fDeadline = 0;
+	fIsApproximate = false;
+	fSink = NULL;
+	fProgress = NULL;
+}
+
+
+/*static*/ DiffEngine*
+DiffEngine::Create(diff_algorithm algorithm, ThreadPool* pool)
+{
+	switch (algorithm) {
+		case DIFF_ALGORITHM_PATIENCE:
+			return new PatienceDiff();
+		case DIFF_ALGORITHM_HISTOGRAM:
+			return new HistogramDiff();
+		case DIFF_ALGORITHM_PARALLEL:
+			// runs a single NPDiff unless the input is worth splitting
+			return new ParallelDiff(pool);
+		case DIFF_ALGORITHM_NP:
+		default:
+			return new NPDiff();
+	}
+}
+
+
+/*static*/ int64_t
+DiffEngine::CurrentTime()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+
+void
+DiffEngine::_StartClock()
+{
+	fIsApproximate = false;
+	fDeadline = (fTimeLimit > 0) ? CurrentTime() + fTimeLimit : 0;
+}
+
+
+/*
+ *	Hands the cost limit, the time left and the progress to an engine that
+ *	diffs a part of the sequences on behalf of this one.
+ */
+void
+DiffEngine::_PassLimits(DiffEngine& engine) const
+{
+	engine.SetCostLimit(fCostLimit);
+	engine.SetMemoryBudget(fMemoryBudget);
+	engine.SetProgress(fProgress);
+	if (fDeadline == 0) {
+		engine.SetTimeLimit(0);
+		return;
+	}
+
+	int64_t timeLeft = fDeadline - CurrentTime();
+	engine.SetTimeLimit((timeLeft > 0) ? timeLeft : 1);
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2007, ICHIMIYA Hironori (Hiron)
+ * Distributed under the terms of the MIT License.
+ *
+ * Authors:
+ * 		ICHIMIYA Hironori (Hiron)
+ *
+ */
+#ifndef DIFFENGINE_H
+#define DIFFENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <pthread.h>
+
+class ThreadPool;
+
+
+class Sequences {
+public:
+						Sequences() {}
+	virtual				~Sequences() {}
+
+	virtual	int			GetLength(int seqNo) const = 0;
+	virtual bool		IsEqual(int index0, int index1) const = 0;
+
+	// Optional: dense element IDs, equal elements having equal IDs and all
+	// IDs being less than GetIDLimit(). NULL if not available.
+	virtual	const uint32_t*	GetIDs(int /* seqNo */) const { return NULL; }
+	virtual	uint32_t	GetIDLimit() const { return 0; }
+};
+
+
+/*
+ *	A window of other sequences, indexed from the beginning of the window.
+ */
+class SubSequences : public Sequences {
+public:
+						SubSequences(const Sequences* base, int begin0, int length0,
+							int begin1, int length1);
+	virtual				~SubSequences() {}
+
+	virtual	int			GetLength(int seqNo) const { return fLength[seqNo]; }
+	virtual bool		IsEqual(int index0, int index1) const
+							{ return fBase->IsEqual(fBegin[0] + index0, fBegin[1] + index1); }
+	virtual	const uint32_t*	GetIDs(int seqNo) const;
+	virtual	uint32_t	GetIDLimit() const { return fBase->GetIDLimit(); }
+
+private:
+	const Sequences*	fBase;
+			int			fBegin[2];
+			int			fLength[2];
+};
+
+
+struct DiffOperation {
+	enum Operator {
+		Inserted = 0,
+		Modified,
+		Deleted,
+		NotChanged,
+	};
+
+	Operator	op;
+	int			from0;
+	int			from1;
+	int			count0;
+	int			count1;
+};
+
+
+/*
+ *	Receives an edit script one operation at a time, in forward order.
+ */
+class DiffOperationSink {
+public:
+	virtual				~DiffOperationSink() {}
+
+	virtual	void		AddOperation(const DiffOperation& operation) = 0;
+};
+
+
+/*
+ *	Progress of a comparison that runs on another thread than the one that
+ *	waits for it. Loading counts the bytes read, the engines count the rounds
+ *	of their search, and both stop early once Cancel() was called.
+ *	Progressed() is called on a working thread, at most once per report
+ *	interval; it may be called from several threads at once.
+ */
+class DiffProgress {
+public:
+						DiffProgress(int64_t reportInterval = 0);
+	virtual				~DiffProgress();
+
+			void		Cancel();
+			bool		IsCanceled();
+
+			void		AddBytes(uint64_t bytes) { _Add(bytes, 0); }
+			void		AddRounds(int64_t rounds) { _Add(0, rounds); }
+			uint64_t	CountBytes();
+			int64_t		CountRounds();
+
+protected:
+	virtual	void		Progressed(uint64_t /* bytes */, int64_t /* rounds */) {}
+
+private:
+			void		_Add(uint64_t bytes, int64_t rounds);
+
+private:
+			pthread_mutex_t	fLock;
+			uint64_t	fBytes;
+			int64_t		fRounds;
+			int64_t		fReportInterval;
+			int64_t		fNextReport;
+			bool		fIsCanceled;
+};
+
+
+enum diff_algorithm {
+	DIFF_ALGORITHM_NP = 0,		//< Wu/Manber/Myers O(NP), minimal
+	DIFF_ALGORITHM_PATIENCE,
+	DIFF_ALGORITHM_HISTOGRAM,
+	DIFF_ALGORITHM_PARALLEL,	//< O(NP) between unique lines, not minimal
+};
+
+
+/*
+ *	Common interface of the diff algorithms. Detect() compares the two
+ *	sequences, GetOperationAt() then returns the edit script in order.
+ *
+ *	The search can be bounded by a number of rounds (the cost limit) and by
+ *	wall-clock time; 0 means no limit. Once a limit is hit, the rest of the
+ *	script is approximated. It is still a valid edit script, but no longer a
+ *	minimal one, and IsApproximate() returns true.
+ *
+ *	With a sink set, Detect() hands each operation to the sink as soon as it
+ *	is complete and keeps none of them; GetOperationAt() then returns NULL.
+ *
+ *	The memory budget bounds what a single search may use for its trace;
+ *	see NPDiff. Like the limits, it is passed on to the engines used inside.
+ *
+ *	With a progress set, the search rounds are counted there, and a canceled
+ *	progress ends the search like running out of time does.
+ */
+class DiffEngine {
+public:
+						DiffEngine();
+	virtual				~DiffEngine() {}
+
+	virtual	void			Detect(const Sequences* sequences) = 0;
+	virtual	const DiffOperation*	GetOperationAt(int index) const = 0;
+
+			void			SetCostLimit(int rounds) { fCostLimit = rounds; }
+			int				GetCostLimit() const { return fCostLimit; }
+			void			SetTimeLimit(int64_t microseconds)
+								{ fTimeLimit = microseconds; }
+			int64_t			GetTimeLimit() const { return fTimeLimit; }
+			void			SetMemoryBudget(size_t bytes) { fMemoryBudget = bytes; }
+			size_t			GetMemoryBudget() const { return fMemoryBudget; }
+			bool			IsApproximate() const { return fIsApproximate; }
+
+			void			SetSink(DiffOperationSink* sink) { fSink = sink; }
+			DiffOperationSink*	GetSink() const { return fSink; }
+			void			SetProgress(DiffProgress* progress)
+								{ fProgress = progress; }
+			DiffProgress*	GetProgress() const { return fProgress; }
+
+	static	DiffEngine*		Create(diff_algorithm algorithm, ThreadPool* pool = NULL);
+	static	int64_t			CurrentTime();
+
+	static	const size_t	kDefaultMemoryBudget;
+
+protected:
+			// to be called at the start of Detect()
+			void			_StartClock();
+			void			_PassLimits(DiffEngine& engine) const;
+			void			_SetApproximate() { fIsApproximate = true; }
+			int64_t			_Deadline() const { return fDeadline; }
+
+private:
+			int				fCostLimit;
+			int64_t			fTimeLimit;
+			size_t			fMemoryBudget;
+			int64_t			fDeadline;		//< 0 if there is no time limit
+			bool			fIsApproximate;
+			DiffOperationSink*	fSink;
+			DiffProgress*	fProgress;
+};
+
+#endif // DIFFENGINE_H
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "DiffScript.h"
+
+
+DiffScript::DiffScript()
+{
+	fSink = NULL;
+}
+
+
+DiffScript::~DiffScript()
+{
+}
+
+
+void
+DiffScript::Append(DiffOperation::Operator op, int from0, int from1, int count0, int count1)
+{
+	if (count0 == 0 && count1 == 0)
+		return;
+
+	if (!fOperations.empty()) {
+		DiffOperation& lastOperation = fOperations.back();
+		if (lastOperation.from0 + lastOperation.count0 == from0
+			&& lastOperation.from1 + lastOperation.count1 == from1) {
+			bool toBind = false;
+			if (DiffOperation::NotChanged == op)
+				toBind = (DiffOperation::NotChanged == lastOperation.op);
+			else if (DiffOperation::NotChanged != lastOperation.op) {
+				if (op != lastOperation.op)
+					lastOperation.op = DiffOperation::Modified;
+				toBind = true;
+			}
+
+			if (toBind) {
+				lastOperation.count0 += count0;
+				lastOperation.count1 += count1;
+				return;
+			}
+		}
+	}
+
+	Flush();
+
+	DiffOperation operation;
+	operation.op = op;
+	operation.from0 = from0;
+	operation.from1 = from1;
+	operation.count0 = count0;
+	operation.count1 = count1;
+	fOperations.push_back(operation);
+}
+
+
+void
+DiffScript::Append(const DiffOperation& operation)
+{
+	Append(operation.op, operation.from0, operation.from1, operation.count0,
+		operation.count1);
+}
+
+
+void
+DiffScript::Flush()
+{
+	if (fSink == NULL || fOperations.empty())
+		return;
+
+	fSink->AddOperation(fOperations.back());
+	fOperations.clear();
+}
+
+
+const DiffOperation*
+DiffScript::GetOperationAt(int index) const
+{
+	if (index < 0 || index >= static_cast<int>(fOperations.size()))
+		return NULL;
+
+	return &fOperations[index];
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef DIFFSCRIPT_H
+#define DIFFSCRIPT_H
+
+#include <vector>
+
+#include "DiffEngine.h"
+
+
+/*
+ *	An edit script in forward order. Appended operations are merged with the
+ *	last one when they continue it.
+ *
+ *	With a sink set, the script only holds the operation that may still be
+ *	merged with the next one, and passes on the others; Flush() passes on
+ *	the last one.
+ */
+class DiffScript : public DiffOperationSink {
+public:
+						DiffScript();
+	virtual				~DiffScript();
+
+			void		SetSink(DiffOperationSink* sink) { fSink = sink; }
+			void		Clear() { fOperations.clear(); }
+			void		Append(DiffOperation::Operator op, int from0, int from1, int count0,
+							int count1);
+			void		Append(const DiffOperation& operation);
+			void		Flush();
+
+	virtual	void		AddOperation(const DiffOperation& operation)
+							{ Append(operation); }
+
+			int			CountOperations() const { return fOperations.size(); }
+	const DiffOperation*	GetOperationAt(int index) const;
+
+private:
+	typedef std::vector<DiffOperation> DiffOpVector;
+
+	DiffOpVector		fOperations;
+	DiffOperationSink*	fSink;
+};
+
+#endif // DIFFSCRIPT_H
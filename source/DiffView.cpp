@@ -15,21 +15,137 @@
 
 #include "CommandIDs.h"
 #include "Exception.h"
+#include "IncrementalDiff.h"
+#include "LineInterner.h"
+#include "TextCache.h"
 #include "TextFileFilter.h"
+#include "ThreadPool.h"
 
+#include <Catalog.h>
 #include <ControlLook.h>
 #include <LayoutBuilder.h>
+#include <Messenger.h>
+#include <Path.h>
 #include <ScrollBar.h>
 #include <ScrollView.h>
 #include <SeparatorView.h>
+#include <String.h>
 #include <Window.h>
 
+#include <algorithm>
 #include <cstdio>
 
+
+#undef B_TRANSLATION_CONTEXT
+#define B_TRANSLATION_CONTEXT "DiffView"
+
+
+class DiffView::LoadTask : public PoolTask {
+public:
+	LoadTask(TextCache* cache, const BPath& path, ThreadPool* pool, DiffProgress* progress)
+		:
+		fCache(cache),
+		fPath(path),
+		fPool(pool),
+		fProgress(progress),
+		fText(NULL),
+		fException(NULL)
+	{
+	}
+
+	virtual void Run()
+	{
+		try {
+			fText = fCache->Acquire(fPath, fPool, fProgress);
+		} catch (Exception* ex) {
+			fException = ex;
+		}
+	}
+
+	TextCache*			fCache;
+	const BPath&		fPath;
+	ThreadPool*			fPool;
+	DiffProgress*		fProgress;
+	const LineSeparatedText*	fText;
+	Exception*			fException;
+};
+
+
+// How often a job reports its progress to the window.
+static const int64_t PROGRESS_INTERVAL = 100000;
+
+// A finished job keeps trying to report back until it is canceled.
+static const bigtime_t FINISH_SEND_TIMEOUT = 100000;
+
+
+/*
+ *	One comparison, run as a job of the pool: the files to load again, and
+ *	the progress, which is reported to the view as MSG_DIFF_PROGRESS.
+ */
+class DiffView::Job : public PoolTask, public DiffProgress {
+public:
+	Job(DiffView* view, int32 serial, const BPath& pathLeft, const BPath& pathRight,
+			bool reloadLeft, bool reloadRight)
+		:
+		DiffProgress(PROGRESS_INTERVAL),
+		fView(view),
+		fMessenger(view),
+		fSerial(serial),
+		fPathLeft(pathLeft),
+		fPathRight(pathRight),
+		fReloadLeft(reloadLeft),
+		fReloadRight(reloadRight),
+		fAlgorithm(view->Algorithm())
+	{
+	}
+
+	virtual void Run()
+	{
+		fView->_RunJob();
+		_SendFinished();
+	}
+
+protected:
+	virtual void Progressed(uint64_t bytes, int64_t rounds)
+	{
+		// dropped if the window is busy, a later report follows anyway
+		BMessage message(MSG_DIFF_PROGRESS);
+		message.AddInt32("serial", fSerial);
+		message.AddUInt64("bytes", bytes);
+		message.AddInt64("rounds", rounds);
+		fMessenger.SendMessage(&message, (BHandler*)NULL, 0);
+	}
+
+private:
+	void _SendFinished()
+	{
+		BMessage message(MSG_DIFF_FINISHED);
+		message.AddInt32("serial", fSerial);
+		while (fMessenger.SendMessage(&message, (BHandler*)NULL, FINISH_SEND_TIMEOUT)
+				== B_TIMED_OUT && !IsCanceled()) {
+		}
+	}
+
+public:
+	DiffView*			fView;
+	BMessenger			fMessenger;
+	int32				fSerial;
+	BPath				fPathLeft;
+	BPath				fPathRight;
+	bool				fReloadLeft;
+	bool				fReloadRight;
+	diff_algorithm		fAlgorithm;
+};
+
+
 static const char FONT_SAMPLE[] = " 0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
 static const int FONT_SAMPLE_LENGTH = sizeof(FONT_SAMPLE) - 1;
 static const int TAB_CHARS = 4;
 
+// Beyond this, the diff is finished with an approximation instead of
+// keeping the user waiting any longer.
+static const int64_t DIFF_TIME_LIMIT = 5000000;
+
 enum system_theme {
 	LIGHT = 0,
 	DARK = 1
@@ -66,9 +182,20 @@ perceptual_brightness(rgb_color color)
 
 DiffView::DiffView(const char* name)
 	:
-	BView("name", B_WILL_DRAW | B_FRAME_EVENTS | B_FULL_UPDATE_ON_RESIZE | B_SUPPORTS_LAYOUT)
+	BView("name", B_WILL_DRAW | B_FRAME_EVENTS | B_FULL_UPDATE_ON_RESIZE | B_SUPPORTS_LAYOUT),
+	fSequences(&fInterner)
 {
+	fJob = NULL;
+	fJobSerial = 0;
+	fLoadedBytes = 0;
+	fRounds = 0;
+	fPool = NULL;
+	fTextCache = NULL;
+	fTextData[LEFT_PANE] = NULL;
+	fTextData[RIGHT_PANE] = NULL;
 	fIsPanesScrolling = false;
+	fApproximate = false;
+	fAlgorithm = DIFF_ALGORITHM_NP;
 
 	_Initialize();
 }
@@ -76,6 +203,9 @@ DiffView::DiffView(const char* name)
 
 DiffView::~DiffView()
 {
+	_StopJob();
+	fSequences.Clear();
+	_ReleaseTexts();
 }
 
 
@@ -128,6 +258,33 @@ DiffView::MessageReceived(BMessage* message)
 			}
 		} break;
 
+		case MSG_DIFF_PROGRESS:
+		{
+			// reports of a canceled job may still arrive
+			int32 serial;
+			if (fJob == NULL || message->FindInt32("serial", &serial) != B_OK
+				|| serial != fJob->fSerial)
+				break;
+
+			message->FindUInt64("bytes", &fLoadedBytes);
+			message->FindInt64("rounds", &fRounds);
+			BView* pane;
+			if ((pane = FindView("LeftPane")) != NULL)
+				pane->Invalidate();
+			if ((pane = FindView("RightPane")) != NULL)
+				pane->Invalidate();
+		} break;
+
+		case MSG_DIFF_FINISHED:
+		{
+			int32 serial;
+			if (fJob == NULL || message->FindInt32("serial", &serial) != B_OK
+				|| serial != fJob->fSerial)
+				break;
+
+			_FinishJob();
+		} break;
+
 		default:
 			BView::MessageReceived(message);
 			break;
@@ -205,127 +362,275 @@ DiffView::_PaneScrolled(float x, float y, DiffView::PaneIndex fromPaneIndex)
 }
 
 
-class LineSeparatedSequences : public Sequences
+/*
+ *	Loads both files and compares them on the thread pool. Until the
+ *	result is ready, the panes show the progress instead of the previous
+ *	result.
+ */
+void
+DiffView::ExecuteDiff(BPath pathLeft, BPath pathRight)
 {
-private:
-	const LineSeparatedText* leftText;
-	const LineSeparatedText* rightText;
+	_StartJob(new Job(this, ++fJobSerial, pathLeft, pathRight, true, true));
+}
 
-public:
-	LineSeparatedSequences(const LineSeparatedText* leftText, const LineSeparatedText* rightText)
-	{
-		this->leftText = leftText;
-		this->rightText = rightText;
+
+/*
+ *	Loads only the files that changed again and keeps the text, line index
+ *	and line IDs of the other side. Without a previous result, both files are
+ *	loaded; with neither flag set, only the comparison is run again.
+ */
+void
+DiffView::ReloadDiff(BPath pathLeft, BPath pathRight, bool reloadLeft, bool reloadRight)
+{
+	_StartJob(new Job(this, ++fJobSerial, pathLeft, pathRight, reloadLeft, reloadRight));
+}
+
+
+/*
+ *	Shows the current result with the sides exchanged, without loading or
+ *	comparing the files again. The paths are those after the exchange; they
+ *	are only used if there is no result yet.
+ */
+void
+DiffView::SwapDiff(BPath pathLeft, BPath pathRight)
+{
+	if (IsBusy() || fSequences.GetLength(0) + fSequences.GetLength(1) == 0) {
+		ExecuteDiff(pathLeft, pathRight);
+		return;
 	}
 
-	~LineSeparatedSequences() {}
+	std::swap(fTextData[LEFT_PANE], fTextData[RIGHT_PANE]);
+	fSequences.SwapSides();
+	fRowMap.SwapSides();
 
-	virtual int GetLength(int seqNo) const
-	{
-		switch (seqNo) {
-			case 0:
-				return leftText->GetLineCount();
-				break;
-			case 1:
-				return rightText->GetLineCount();
-				break;
-			default:
-				return 0;
-		}
+	_DataChanged();
+}
+
+
+/*
+ *	Cancels the current job, if any, and queues the given one. The jobs of
+ *	all windows take turns on the shared pool.
+ */
+void
+DiffView::_StartJob(Job* job)
+{
+	_StopJob();
+
+	fJob = job;
+	fLoadedBytes = 0;
+	fRounds = 0;
+	if (fPool == NULL) {
+		// without a pool, the job has to block the window
+		_RunJob();
+		_FinishJob();
+		return;
 	}
 
-	virtual bool IsEqual(int index0, int index1) const
-	{
-		return leftText->GetLineAt(index0) == rightText->GetLineAt(index1);
+	fPool->SubmitJob(fJob, &fJobGroup);
+	_DataChanged();
+}
+
+
+/*
+ *	Cancels the current job and waits for it, throwing its result away. A
+ *	job that has not started yet is just taken out of the queue.
+ */
+void
+DiffView::_StopJob()
+{
+	if (fJob == NULL)
+		return;
+
+	fJob->Cancel();
+	if (fPool != NULL)
+		fPool->Withdraw(fJob);
+	fJobGroup.Wait();
+	delete fJob;
+	fJob = NULL;
+}
+
+
+/*
+ *	Takes over the result of the job that has just reported its end.
+ */
+void
+DiffView::_FinishJob()
+{
+	fJobGroup.Wait();
+	delete fJob;
+	fJob = NULL;
+
+	_DataChanged();
+	Window()->PostMessage(MSG_DIFF_FINISHED);
+}
+
+
+void
+DiffView::_RunJob()
+{
+	if (fJob->fReloadLeft && fJob->fReloadRight)
+		_Execute(fJob->fPathLeft, fJob->fPathRight);
+	else {
+		_Reload(fJob->fPathLeft, fJob->fPathRight, fJob->fReloadLeft,
+			fJob->fReloadRight);
 	}
-};
+}
 
 
 void
-DiffView::ExecuteDiff(BPath pathLeft, BPath pathRight)
+DiffView::_Execute(const BPath& pathLeft, const BPath& pathRight)
 {
-	fTextData[LEFT_PANE].Unload();
-	fTextData[RIGHT_PANE].Unload();
-	fLineInfos.clear();
+	fSequences.Clear();
+	_ReleaseTexts();
+	fRowMap.Clear();
 
-	fIdentical = true;
+	fApproximate = false;
 	try {
-		fTextData[LEFT_PANE].Load(pathLeft);
-		fTextData[RIGHT_PANE].Load(pathRight);
-
-		LineSeparatedSequences seqs(&fTextData[LEFT_PANE], &fTextData[RIGHT_PANE]);
-		NPDiff diffEngine;
-		diffEngine.Detect(&seqs);
+		_LoadTexts(pathLeft, pathRight);
+		fSequences.Assign(0, *fTextData[LEFT_PANE]);
+		fSequences.Assign(1, *fTextData[RIGHT_PANE]);
+		_RunDiff(DiffEngine::Create(fJob->fAlgorithm, fPool));
+	} catch (Exception* ex) {
+		ex->Delete();
+		fSequences.Clear();
+		fRowMap.Clear();
+	}
+}
 
-		int index;
-		for (index = 0;; index++) {
-			const DiffOperation* diffOperation = diffEngine.GetOperationAt(index);
-			if (diffOperation == NULL)
-				break;
 
-			LineInfo line;
-			line.op = diffOperation->op;
-
-			int count, maxCount;
-			switch (diffOperation->op) {
-				case DiffOperation::Inserted:
-					line.textIndex[LEFT_PANE] = -1;
-					line.textIndex[RIGHT_PANE] = diffOperation->from1;
-					maxCount = diffOperation->count1;
-					for (count = 0; count < maxCount; count++) {
-						fLineInfos.push_back(line);
-						line.textIndex[RIGHT_PANE]++;
-					}
-					fIdentical = false;
-					break;
+/*
+ *	When one side changed, the previous result is updated around the lines
+ *	that differ from its previous version instead of being detected anew.
+ */
+void
+DiffView::_Reload(const BPath& pathLeft, const BPath& pathRight, bool reloadLeft,
+	bool reloadRight)
+{
+	if ((reloadLeft && reloadRight) || fSequences.GetLength(0) + fSequences.GetLength(1) == 0) {
+		_Execute(pathLeft, pathRight);
+		return;
+	}
 
-				case DiffOperation::Modified:
-					line.textIndex[LEFT_PANE] = diffOperation->from0;
-					line.textIndex[RIGHT_PANE] = diffOperation->from1;
-					maxCount = (diffOperation->count0 > diffOperation->count1)
-						? diffOperation->count0
-						: diffOperation->count1;
-					for (count = 0; count < maxCount; count++) {
-						fLineInfos.push_back(line);
-						if (count + 1 < diffOperation->count0)
-							line.textIndex[LEFT_PANE]++;
-						else
-							line.textIndex[LEFT_PANE] = -1;
-						if (count + 1 < diffOperation->count1)
-							line.textIndex[RIGHT_PANE]++;
-						else
-							line.textIndex[RIGHT_PANE] = -1;
-					}
-					fIdentical = false;
-					break;
+	// an approximate result is not worth keeping
+	IncrementalDiff::OperationVector previous;
+	if ((reloadLeft || reloadRight) && !fApproximate) {
+		int32_t index;
+		for (index = 0; index < fRowMap.CountOperations(); index++)
+			previous.push_back(fRowMap.OperationAt(index));
+	}
 
-				case DiffOperation::Deleted:
-					line.textIndex[LEFT_PANE] = diffOperation->from0;
-					line.textIndex[RIGHT_PANE] = -1;
-					maxCount = diffOperation->count0;
-					for (count = 0; count < maxCount; count++) {
-						fLineInfos.push_back(line);
-						line.textIndex[LEFT_PANE]++;
-					}
-					fIdentical = false;
-					break;
+	fRowMap.Clear();
+	fApproximate = false;
+	try {
+		DiffEngine* diffEngine = DiffEngine::Create(fJob->fAlgorithm, fPool);
+		if (reloadLeft || reloadRight) {
+			PaneIndex pane = reloadLeft ? LEFT_PANE : RIGHT_PANE;
+			int previousLength = fSequences.GetLength(pane);
+
+			// the interner refers to the previous text until it is reassigned
+			const LineSeparatedText* previousText = fTextData[pane];
+			fTextData[pane] = NULL;
+			int headCount;
+			int tailCount;
+			try {
+				fTextData[pane] = fTextCache->Acquire(reloadLeft ? pathLeft : pathRight,
+					fPool, fJob);
+				fSequences.Reassign(pane, *fTextData[pane], &headCount, &tailCount);
+			} catch (...) {
+				fTextCache->Release(previousText);
+				delete diffEngine;
+				throw;
+			}
+			fTextCache->Release(previousText);
 
-				case DiffOperation::NotChanged:
-					line.textIndex[LEFT_PANE] = diffOperation->from0;
-					line.textIndex[RIGHT_PANE] = diffOperation->from1;
-					maxCount = diffOperation->count0;
-					for (count = 0; count < maxCount; count++) {
-						fLineInfos.push_back(line);
-						line.textIndex[LEFT_PANE]++;
-						line.textIndex[RIGHT_PANE]++;
-					}
-					break;
+			if (!previous.empty()) {
+				IncrementalDiff* incrementalDiff = new IncrementalDiff(diffEngine);
+				incrementalDiff->SetPrevious(previous, pane, headCount,
+					previousLength - tailCount, fSequences.GetLength(pane) - tailCount);
+				diffEngine = incrementalDiff;
 			}
 		}
+		_RunDiff(diffEngine);
 	} catch (Exception* ex) {
 		ex->Delete();
+		fSequences.Clear();
+		fRowMap.Clear();
 	}
+}
+
 
+/*
+ *	Both files are read and split at the same time, so a slow disk or share
+ *	on one side does not hold up the other.
+ */
+void
+DiffView::_LoadTexts(const BPath& pathLeft, const BPath& pathRight)
+{
+	LoadTask leftTask(fTextCache, pathLeft, fPool, fJob);
+	LoadTask rightTask(fTextCache, pathRight, fPool, fJob);
+	if (fPool != NULL) {
+		TaskGroup group;
+		fPool->Submit(&leftTask, &group);
+		fPool->Submit(&rightTask, &group);
+		fPool->Wait(&group);
+	} else {
+		leftTask.Run();
+		rightTask.Run();
+	}
+
+	fTextData[LEFT_PANE] = leftTask.fText;
+	fTextData[RIGHT_PANE] = rightTask.fText;
+	if (leftTask.fException != NULL) {
+		if (rightTask.fException != NULL)
+			rightTask.fException->Delete();
+		throw leftTask.fException;
+	}
+	if (rightTask.fException != NULL)
+		throw rightTask.fException;
+}
+
+
+/*
+ *	Gives the texts back to the cache. The sequences must not refer to them
+ *	any longer.
+ */
+void
+DiffView::_ReleaseTexts()
+{
+	if (fTextCache == NULL)
+		return;
+
+	fTextCache->Release(fTextData[LEFT_PANE]);
+	fTextCache->Release(fTextData[RIGHT_PANE]);
+	fTextData[LEFT_PANE] = NULL;
+	fTextData[RIGHT_PANE] = NULL;
+}
+
+
+/*
+ *	Runs the comparison of the assigned sequences into the row map and
+ *	deletes the engine afterwards.
+ */
+void
+DiffView::_RunDiff(DiffEngine* diffEngine)
+{
+	try {
+		diffEngine->SetTimeLimit(DIFF_TIME_LIMIT);
+		diffEngine->SetSink(&fRowMap);
+		diffEngine->SetProgress(fJob);
+		diffEngine->Detect(&fSequences);
+		fApproximate = diffEngine->IsApproximate();
+	} catch (...) {
+		delete diffEngine;
+		throw;
+	}
+	delete diffEngine;
+}
+
+
+void
+DiffView::_DataChanged()
+{
 	DiffPaneView* leftPaneView = dynamic_cast<DiffPaneView*>(FindView("LeftPane"));
 	if (leftPaneView != NULL)
 		leftPaneView->DataChanged();
@@ -434,8 +739,9 @@ DiffView::DiffPaneView::_AdjustScrollBar()
 float
 DiffView::DiffPaneView::_GetDataHeight()
 {
+	// the data belongs to the worker until its job is done
 	if (fDataHeight < 0) {
-		if (fDiffView != NULL) {
+		if (fDiffView != NULL && !fDiffView->IsBusy()) {
 			BFont font;
 			GetFont(&font);
 
@@ -443,7 +749,7 @@ DiffView::DiffPaneView::_GetDataHeight()
 			font.GetHeight(&fh);
 			float lineHeight = static_cast<float>(ceil(fh.ascent + fh.descent + fh.leading));
 
-			fDataHeight = fDiffView->fLineInfos.size() * lineHeight;
+			fDataHeight = fDiffView->fRowMap.CountRows() * lineHeight;
 		}
 	}
 
@@ -454,39 +760,37 @@ DiffView::DiffPaneView::_GetDataHeight()
 float
 DiffView::DiffPaneView::_GetDataWidth()
 {
-	if ((fDataWidth >= 0) || (fDiffView == NULL))
+	if ((fDataWidth >= 0) || (fDiffView == NULL) || fDiffView->IsBusy())
 		return fDataWidth;
 
-	int lineEnd = fDiffView->fLineInfos.size();
+	// every line of the pane's text is shown in exactly one row
+	const LineSeparatedText* textData = fDiffView->fTextData[fPaneIndex];
+	int lineEnd = (textData != NULL) ? textData->GetLineCount() : 0;
 	int line;
 	for (line = 0; line < lineEnd; line++) {
-		const LineInfo& linfo = fDiffView->fLineInfos[line];
-		if (linfo.textIndex[fPaneIndex] >= 0) {
-			const Substring& text
-				= fDiffView->fTextData[fPaneIndex].GetLineAt(linfo.textIndex[fPaneIndex]);
-			BFont font;
-			GetFont(&font);
-			float left = 0;
-			const char* subTextBegin = text.Begin();
-			const char* end = text.End();
-			const char* ptr;
-			for (ptr = subTextBegin; ptr < end; ptr++) {
-				if ('\t' == *ptr || '\r' == *ptr || '\n' == *ptr) {
-					int count = ptr - subTextBegin;
-					if (count > 0)
-						left += font.StringWidth(subTextBegin, ptr - subTextBegin);
-					subTextBegin = ptr + 1;
-				}
+		Substring text = textData->GetLineAt(line);
+		BFont font;
+		GetFont(&font);
+		float left = 0;
+		const char* subTextBegin = text.Begin();
+		const char* end = text.End();
+		const char* ptr;
+		for (ptr = subTextBegin; ptr < end; ptr++) {
+			if ('\t' == *ptr || '\r' == *ptr || '\n' == *ptr) {
+				int count = ptr - subTextBegin;
+				if (count > 0)
+					left += font.StringWidth(subTextBegin, ptr - subTextBegin);
+				subTextBegin = ptr + 1;
+			}
 
-				if ('\t' == *ptr) {
-					if (fTabUnit < 0) {
-						fTabUnit = font.StringWidth(FONT_SAMPLE, FONT_SAMPLE_LENGTH)
-							/ FONT_SAMPLE_LENGTH * TAB_CHARS;
-					}
-					left = (floor(left / fTabUnit) + 1) * fTabUnit;
+			if ('\t' == *ptr) {
+				if (fTabUnit < 0) {
+					fTabUnit = font.StringWidth(FONT_SAMPLE, FONT_SAMPLE_LENGTH)
+						/ FONT_SAMPLE_LENGTH * TAB_CHARS;
 				}
-				fDataWidth = std::max(fDataWidth, left);
+				left = (floor(left / fTabUnit) + 1) * fTabUnit;
 			}
+			fDataWidth = std::max(fDataWidth, left);
 		}
 	}
 
@@ -518,12 +822,17 @@ DiffView::DiffPaneView::Draw(BRect updateRect)
 	font.GetHeight(&fh);
 	float lineHeight = static_cast<float>(ceil(fh.ascent + fh.descent + fh.leading));
 
+	if (fDiffView->IsBusy()) {
+		_DrawProgress(lineHeight, fh.ascent);
+		return;
+	}
+
 	int lineBegin = static_cast<int>(floor(updateRect.top / lineHeight));
 	if (lineBegin < 0)
 		lineBegin = 0;
 	int lineEnd = static_cast<int>(floor((updateRect.bottom + 1) / lineHeight)) + 1;
-	if (static_cast<unsigned int>(lineEnd) > fDiffView->fLineInfos.size())
-		lineEnd = fDiffView->fLineInfos.size();
+	if (lineEnd > fDiffView->fRowMap.CountRows())
+		lineEnd = fDiffView->fRowMap.CountRows();
 
 	int brightness = perceptual_brightness(ui_color(B_DOCUMENT_TEXT_COLOR));
 	system_theme theme;
@@ -531,7 +840,8 @@ DiffView::DiffPaneView::Draw(BRect updateRect)
 	int line;
 	for (line = lineBegin; line < lineEnd; line++) {
 		rgb_color oldLowColor = LowColor();
-		const LineInfo& linfo = fDiffView->fLineInfos[line];
+		RowMap::Row linfo;
+		fDiffView->fRowMap.GetRowAt(line, linfo);
 
 		rgb_color bkColor;
 		bool isDrawBackground = false;
@@ -571,8 +881,8 @@ DiffView::DiffPaneView::Draw(BRect updateRect)
 		}
 
 		if (linfo.textIndex[fPaneIndex] >= 0) {
-			const Substring& paneText
-				= fDiffView->fTextData[fPaneIndex].GetLineAt(linfo.textIndex[fPaneIndex]);
+			Substring paneText
+				= fDiffView->fTextData[fPaneIndex]->GetLineAt(linfo.textIndex[fPaneIndex]);
 			_DrawText(font, paneText, lineHeight * line + fh.ascent);
 		}
 		SetLowColor(oldLowColor);
@@ -611,6 +921,32 @@ DiffView::DiffPaneView::_DrawText(const BFont& font, const Substring& text, floa
 }
 
 
+/*
+ *	Stands in for the result while the worker is busy.
+ */
+void
+DiffView::DiffPaneView::_DrawProgress(float lineHeight, float ascent)
+{
+	BString details(B_TRANSLATE("%size% MiB read"));
+	BString size;
+	size.SetToFormat("%.1f", fDiffView->fLoadedBytes / (1024.0 * 1024.0));
+	details.ReplaceFirst("%size%", size.String());
+	if (fDiffView->fRounds > 0) {
+		BString rounds(B_TRANSLATE("%rounds% search rounds"));
+		BString count;
+		count << fDiffView->fRounds;
+		rounds.ReplaceFirst("%rounds%", count.String());
+		details << ", " << rounds;
+	}
+
+	float left = be_control_look->DefaultLabelSpacing();
+	SetHighUIColor(B_DOCUMENT_TEXT_COLOR, B_DISABLED_MARK_TINT);
+	DrawString(B_TRANSLATE("Comparing" B_UTF8_ELLIPSIS), BPoint(left, lineHeight + ascent));
+	DrawString(details.String(), BPoint(left, 2 * lineHeight + ascent));
+	SetHighUIColor(B_DOCUMENT_TEXT_COLOR);
+}
+
+
 void
 DiffView::DiffPaneView::ScrollTo(BPoint point)
 {
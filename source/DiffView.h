@@ -15,9 +15,13 @@
 #include <vector>
 
 #include "LineSeparatedText.h"
-#include "NPDiff.h"
+#include "DiffEngine.h"
+#include "LineInterner.h"
+#include "RowMap.h"
+#include "ThreadPool.h"
 
 class BPath;
+class TextCache;
 
 
 class DiffView : public BView {
@@ -28,7 +32,17 @@ public:
 	virtual	void		MessageReceived(BMessage* message);
 
 			void		ExecuteDiff(BPath pathLeft, BPath pathRight);
-			bool		isIdentical() { return fIdentical; };
+			void		ReloadDiff(BPath pathLeft, BPath pathRight,
+							bool reloadLeft, bool reloadRight);
+			void		SwapDiff(BPath pathLeft, BPath pathRight);
+			bool		isIdentical() { return !IsBusy() && fRowMap.IsIdentical(); };
+			bool		isApproximate() { return !IsBusy() && fApproximate; };
+			bool		IsBusy() const { return fJob != NULL; }
+
+			void		SetAlgorithm(diff_algorithm algorithm) { fAlgorithm = algorithm; }
+			void		SetTextCache(TextCache* cache) { fTextCache = cache; }
+			void		SetThreadPool(ThreadPool* pool) { fPool = pool; }
+		diff_algorithm	Algorithm() const { return fAlgorithm; }
 
 private:
 	enum PaneIndex {
@@ -70,6 +84,7 @@ private:
 				float		_GetDataHeight();
 				float		_GetDataWidth();
 				void		_DrawText(const BFont& font, const Substring& text, float baseLine);
+				void		_DrawProgress(float lineHeight, float ascent);
 
 	private:
 		DiffView*			fDiffView;
@@ -81,17 +96,43 @@ private:
 	};
 	friend class DiffPaneView;
 
-	struct LineInfo {
-		int32 textIndex[PaneMAX];
-		DiffOperation::Operator op;
-	};
-	typedef std::vector<LineInfo> LineInfoVector;
+	class LoadTask;
+	class Job;
+
+private:
+			void		_StartJob(Job* job);
+			void		_StopJob();
+			void		_FinishJob();
+
+			// on a pool thread
+			void		_RunJob();
+			void		_Execute(const BPath& pathLeft, const BPath& pathRight);
+			void		_Reload(const BPath& pathLeft, const BPath& pathRight,
+							bool reloadLeft, bool reloadRight);
+			void		_LoadTexts(const BPath& pathLeft, const BPath& pathRight);
+			void		_ReleaseTexts();
+			void		_RunDiff(DiffEngine* diffEngine);
+
+			void		_DataChanged();
 
 private:
-		LineSeparatedText	fTextData[PaneMAX];
-		LineInfoVector		fLineInfos;
+		// While a job is queued or running, only the job touches the texts,
+		// the sequences and the row map; the panes show its progress.
+		Job*				fJob;			//< NULL if there is no job
+		TaskGroup			fJobGroup;
+		int32				fJobSerial;
+		uint64				fLoadedBytes;
+		int64				fRounds;
+
+		ThreadPool*			fPool;			//< shared by all windows
+		TextCache*			fTextCache;		//< shared by all windows
+	const LineSeparatedText*	fTextData[PaneMAX];	//< NULL until loaded
+		LineInterner		fInterner;
+		InternedSequences	fSequences;		//< empty unless both texts loaded
+		RowMap				fRowMap;
 		bool				fIsPanesScrolling;
-		bool				fIdentical;
+		bool				fApproximate;
+		diff_algorithm		fAlgorithm;
 };
 
 #endif // TEXTDIFFVIEW_H
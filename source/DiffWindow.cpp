@@ -45,6 +45,8 @@ DiffWindow::DiffWindow(BMessage* settings, int32 windowcount)
 	_CreateMainMenu(menuBar);
 
 	fDiffView = new DiffView("DiffView");
+	fDiffView->SetTextCache(static_cast<App*>(be_app)->GetTextCache());
+	fDiffView->SetThreadPool(static_cast<App*>(be_app)->GetThreadPool());
 
 	BLayoutBuilder::Group<>(this, B_VERTICAL, 0)
 		.Add(menuBar)
@@ -188,10 +190,28 @@ DiffWindow::MessageReceived(BMessage* message)
 			fPathLeft = fPathRight;
 			fPathRight = tempPath;
 
-			fDiffView->ExecuteDiff(fPathLeft, fPathRight);
+			fDiffView->SwapDiff(fPathLeft, fPathRight);
 			_UpdateTitle();
 		} break;
 
+		case MSG_ALGORITHM:
+		{
+			int32 algorithm;
+			if (message->FindInt32("algorithm", &algorithm) != B_OK
+				|| algorithm == fDiffView->Algorithm())
+				break;
+
+			fDiffView->SetAlgorithm(static_cast<diff_algorithm>(algorithm));
+			if (fPathLeft.InitCheck() == B_OK && fPathRight.InitCheck() == B_OK) {
+				fDiffView->ReloadDiff(fPathLeft, fPathRight, false, false);
+				_UpdateTitle();
+			}
+		} break;
+
+		case MSG_DIFF_FINISHED:
+			_UpdateTitle();
+			break;
+
 		default:
 			BWindow::MessageReceived(message);
 			break;
@@ -273,6 +293,35 @@ DiffWindow::_CreateMainMenu(BMenuBar* menuBar)
 	menuItem = new BMenuItem(B_TRANSLATE("Show right file location"), locationRight, '2', B_SHIFT_KEY);
 	menuItem->SetTarget(this);
 	fileMenu->AddItem(menuItem);
+
+	BMenu* algorithmMenu = new BMenu(B_TRANSLATE("Algorithm"));
+	algorithmMenu->SetRadioMode(true);
+	menuBar->AddItem(algorithmMenu);
+
+	BMessage* algorithmMinimal = new BMessage(MSG_ALGORITHM);
+	algorithmMinimal->AddInt32("algorithm", DIFF_ALGORITHM_NP);
+	menuItem = new BMenuItem(B_TRANSLATE("Minimal"), algorithmMinimal);
+	menuItem->SetTarget(this);
+	menuItem->SetMarked(true);
+	algorithmMenu->AddItem(menuItem);
+
+	BMessage* algorithmPatience = new BMessage(MSG_ALGORITHM);
+	algorithmPatience->AddInt32("algorithm", DIFF_ALGORITHM_PATIENCE);
+	menuItem = new BMenuItem(B_TRANSLATE("Patience"), algorithmPatience);
+	menuItem->SetTarget(this);
+	algorithmMenu->AddItem(menuItem);
+
+	BMessage* algorithmHistogram = new BMessage(MSG_ALGORITHM);
+	algorithmHistogram->AddInt32("algorithm", DIFF_ALGORITHM_HISTOGRAM);
+	menuItem = new BMenuItem(B_TRANSLATE("Histogram"), algorithmHistogram);
+	menuItem->SetTarget(this);
+	algorithmMenu->AddItem(menuItem);
+
+	BMessage* algorithmParallel = new BMessage(MSG_ALGORITHM);
+	algorithmParallel->AddInt32("algorithm", DIFF_ALGORITHM_PARALLEL);
+	menuItem = new BMenuItem(B_TRANSLATE("Parallel"), algorithmParallel);
+	menuItem->SetTarget(this);
+	algorithmMenu->AddItem(menuItem);
 }
 
 
@@ -401,7 +450,8 @@ DiffWindow::_AskToReload(node_ref nref)
 			return;
 
 		case 1:
-			fDiffView->ExecuteDiff(fPathLeft, fPathRight);
+			fDiffView->ReloadDiff(fPathLeft, fPathRight, nref == fLeftNodeRef,
+				nref == fRightNodeRef);
 			_UpdateTitle();
 			break;
 	}
@@ -545,7 +595,13 @@ DiffWindow::_UpdateTitle()
 		title += "|";
 	title += " ► ";
 	title += fPathRight.Leaf();
-
+	if (fDiffView->IsBusy()) {
+		title += " ";
+		title += B_TRANSLATE("(comparing" B_UTF8_ELLIPSIS ")");
+	} else if (fDiffView->isApproximate()) {
+		title += " ";
+		title += B_TRANSLATE("(approximate)");
+	}
 
 	SetTitle(title.String());
 }
@@ -9,7 +9,7 @@
 #ifndef EXCEPTION_H
 #define EXCEPTION_H
 
-#include <Path.h>
+#include <string>
 
 
 class Exception {
@@ -39,18 +39,20 @@ private:
 };
 
 
+// The status is an errno value, so that the engine builds without the
+// Haiku kits.
 class FileException : public Exception {
 public:
-						FileException(int fCode, const BPath& aPath, status_t aStatus = B_NO_ERROR)
+						FileException(int fCode, const char* aPath, int aStatus = 0)
 							: Exception(fCode), fPath(aPath), fStatus(aStatus) {}
 	virtual				~FileException() {}
 
-	const BPath&		GetPath() const { return fPath; }
-	status_t			GetStatus() const { return fStatus; }
+	const char*			GetPath() const { return fPath.c_str(); }
+	int					GetStatus() const { return fStatus; }
 
 private:
-	BPath				fPath;
-	status_t			fStatus;
+	std::string			fPath;
+	int					fStatus;
 };
 
 #endif // EXCEPTION_H
@@ -14,6 +14,8 @@ enum
 	EXCEPTION_NONE			= 0,
 	EXCEPTION_MEMORY		= 1,
 	EXCEPTION_FILE_OPEN		= 2,
+	EXCEPTION_FILE_READ		= 3,
+	EXCEPTION_CANCELED		= 4,
 };
 
 #endif // EXCEPTIONCODE_H
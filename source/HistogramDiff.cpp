@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "HistogramDiff.h"
+
+
+const uint32_t HistogramDiff::kMaxChainLength = 64;
+
+
+HistogramDiff::HistogramDiff()
+{
+}
+
+
+HistogramDiff::~HistogramDiff()
+{
+}
+
+
+bool
+HistogramDiff::_FindMatches(const Region& region, MatchVector& matches)
+{
+	const uint32_t* ids0 = fIDs[0];
+	const uint32_t* ids1 = fIDs[1];
+	std::vector<uint32_t>& counts = fCounts[0];
+
+	// histogram of side 0, with the occurrences of each element chained in
+	// ascending order
+	if (fNext.size() < static_cast<size_t>(region.end0))
+		fNext.resize(region.end0);
+	int index;
+	for (index = region.end0 - 1; index >= region.begin0; index--) {
+		uint32_t id = ids0[index];
+		fNext[index] = fPositions[id];
+		fPositions[id] = index;
+		counts[id]++;
+	}
+
+	Match best;
+	best.count = 0;
+	uint32_t bestCount = kMaxChainLength + 1;
+
+	int index1 = region.begin1;
+	while (index1 < region.end1) {
+		int next1 = index1 + 1;
+		uint32_t id = ids1[index1];
+		if (counts[id] == 0 || counts[id] > bestCount) {
+			index1 = next1;
+			continue;
+		}
+
+		int index0;
+		for (index0 = fPositions[id]; index0 >= 0; index0 = fNext[index0]) {
+			// extend the match in both directions, tracking the lowest
+			// occurrence count inside it
+			uint32_t lowCount = counts[id];
+			int begin0 = index0;
+			int begin1 = index1;
+			while (begin0 > region.begin0 && begin1 > region.begin1
+				&& ids0[begin0 - 1] == ids1[begin1 - 1]) {
+				begin0--;
+				begin1--;
+				if (counts[ids0[begin0]] < lowCount)
+					lowCount = counts[ids0[begin0]];
+			}
+			int end0 = index0 + 1;
+			int end1 = index1 + 1;
+			while (end0 < region.end0 && end1 < region.end1 && ids0[end0] == ids1[end1]) {
+				if (counts[ids0[end0]] < lowCount)
+					lowCount = counts[ids0[end0]];
+				end0++;
+				end1++;
+			}
+
+			if (next1 < end1)
+				next1 = end1;
+			if (best.count < end0 - begin0 || lowCount < bestCount) {
+				best.from0 = begin0;
+				best.from1 = begin1;
+				best.count = end0 - begin0;
+				bestCount = lowCount;
+			}
+		}
+		index1 = next1;
+	}
+
+	for (index = region.begin0; index < region.end0; index++) {
+		counts[ids0[index]] = 0;
+		fPositions[ids0[index]] = -1;
+	}
+
+	if (best.count == 0 || bestCount > kMaxChainLength)
+		return false;
+
+	matches.push_back(best);
+	return true;
+}
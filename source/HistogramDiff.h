@@ -0,0 +1,31 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef HISTOGRAMDIFF_H
+#define HISTOGRAMDIFF_H
+
+#include "AnchoredDiff.h"
+
+
+/*
+ *	Histogram diff, as in JGit: splits each region at the longest common run
+ *	around the elements that occur least often on the first side. Elements
+ *	occurring more than kMaxChainLength times are never used as anchors.
+ */
+class HistogramDiff : public AnchoredDiff {
+public:
+						HistogramDiff();
+	virtual				~HistogramDiff();
+
+	static	const uint32_t	kMaxChainLength;
+
+protected:
+	virtual	bool		_FindMatches(const Region& region, MatchVector& matches);
+
+private:
+			std::vector<int>	fNext;	//< next occurrence on side 0
+};
+
+#endif // HISTOGRAMDIFF_H
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "IncrementalDiff.h"
+
+
+static inline int
+get_from(const DiffOperation& operation, int seqNo)
+{
+	return (seqNo == 0) ? operation.from0 : operation.from1;
+}
+
+
+static inline int
+get_count(const DiffOperation& operation, int seqNo)
+{
+	return (seqNo == 0) ? operation.count0 : operation.count1;
+}
+
+
+IncrementalDiff::IncrementalDiff(DiffEngine* engine)
+{
+	fEngine = engine;
+	fSeqNo = 0;
+	fBegin = 0;
+	fPreviousEnd = 0;
+	fEnd = 0;
+}
+
+
+IncrementalDiff::~IncrementalDiff()
+{
+	delete fEngine;
+}
+
+
+void
+IncrementalDiff::SetPrevious(const OperationVector& operations, int seqNo, int begin,
+	int previousEnd, int end)
+{
+	fPrevious = operations;
+	fSeqNo = seqNo;
+	fBegin = begin;
+	fPreviousEnd = previousEnd;
+	fEnd = end;
+}
+
+
+void
+IncrementalDiff::Detect(const Sequences* sequences)
+{
+	fScript.Clear();
+	fScript.SetSink(GetSink());
+	_StartClock();
+	if (sequences == NULL)
+		return;
+
+	// the previous script has to cover the sequences as they were before
+	int otherNo = 1 - fSeqNo;
+	int shift = fEnd - fPreviousEnd;
+	Point last = { static_cast<int>(fPrevious.size()), 0 };
+	int previousLength[2];
+	_GetPosition(last, previousLength);
+	if (fPrevious.empty() || fBegin > fPreviousEnd || fPreviousEnd > previousLength[fSeqNo]
+		|| previousLength[fSeqNo] + shift != sequences->GetLength(fSeqNo)
+		|| previousLength[otherNo] != sequences->GetLength(otherNo)) {
+		_DetectAll(sequences);
+		return;
+	}
+
+	Point start = _FindStart();
+	Point end = _FindEnd();
+	int startPosition[2];
+	int endPosition[2];
+	_GetPosition(start, startPosition);
+	_GetPosition(end, endPosition);
+	if (endPosition[0] < startPosition[0] || endPosition[1] < startPosition[1]) {
+		_DetectAll(sequences);
+		return;
+	}
+
+	// everything before the window stays as it was
+	int index;
+	for (index = 0; index < start.opIndex; index++)
+		_AppendPart(fPrevious[index], 0, -1, 0);
+	if (start.offset > 0)
+		_AppendPart(fPrevious[start.opIndex], 0, start.offset, 0);
+
+	int length[2];
+	length[0] = endPosition[0] - startPosition[0];
+	length[1] = endPosition[1] - startPosition[1];
+	length[fSeqNo] += shift;
+	SubSequences window(sequences, startPosition[0], length[0], startPosition[1], length[1]);
+	_PassLimits(*fEngine);
+	fEngine->SetSink(NULL);
+	fEngine->Detect(&window);
+	if (fEngine->IsApproximate())
+		_SetApproximate();
+
+	const DiffOperation* operation;
+	for (index = 0; (operation = fEngine->GetOperationAt(index)) != NULL; index++) {
+		fScript.Append(operation->op, startPosition[0] + operation->from0,
+			startPosition[1] + operation->from1, operation->count0, operation->count1);
+	}
+
+	// everything after it moves with the change in length
+	index = end.opIndex;
+	if (end.offset > 0) {
+		const DiffOperation& split = fPrevious[index];
+		_AppendPart(split, end.offset, split.count0 - end.offset, shift);
+		index++;
+	}
+	for (; index < static_cast<int>(fPrevious.size()); index++)
+		_AppendPart(fPrevious[index], 0, -1, shift);
+
+	fScript.Flush();
+}
+
+
+/*
+ *	Returns the earliest point at or before fBegin at which both sequences
+ *	are in step: the start of an operation, or a position inside an
+ *	unchanged one.
+ */
+IncrementalDiff::Point
+IncrementalDiff::_FindStart() const
+{
+	Point point;
+	point.offset = 0;
+	for (point.opIndex = 0; point.opIndex < static_cast<int>(fPrevious.size());
+		point.opIndex++) {
+		const DiffOperation& operation = fPrevious[point.opIndex];
+		int from = get_from(operation, fSeqNo);
+		int count = get_count(operation, fSeqNo);
+		if (from + count > fBegin || (count == 0 && from >= fBegin)) {
+			if (operation.op == DiffOperation::NotChanged && from < fBegin)
+				point.offset = fBegin - from;
+			break;
+		}
+	}
+	return point;
+}
+
+
+/*
+ *	Returns the latest point at or after fPreviousEnd at which both
+ *	sequences are in step.
+ */
+IncrementalDiff::Point
+IncrementalDiff::_FindEnd() const
+{
+	Point point;
+	point.offset = 0;
+	for (point.opIndex = fPrevious.size(); point.opIndex > 0; point.opIndex--) {
+		const DiffOperation& operation = fPrevious[point.opIndex - 1];
+		int from = get_from(operation, fSeqNo);
+		int count = get_count(operation, fSeqNo);
+		if (from < fPreviousEnd || (count == 0 && from <= fPreviousEnd)) {
+			if (operation.op == DiffOperation::NotChanged && from + count > fPreviousEnd) {
+				point.opIndex--;
+				point.offset = fPreviousEnd - from;
+			}
+			break;
+		}
+	}
+	return point;
+}
+
+
+void
+IncrementalDiff::_GetPosition(const Point& point, int position[2]) const
+{
+	if (point.opIndex < static_cast<int>(fPrevious.size())) {
+		const DiffOperation& operation = fPrevious[point.opIndex];
+		position[0] = operation.from0 + point.offset;
+		position[1] = operation.from1 + point.offset;
+	} else if (!fPrevious.empty()) {
+		const DiffOperation& operation = fPrevious.back();
+		position[0] = operation.from0 + operation.count0;
+		position[1] = operation.from1 + operation.count1;
+	} else {
+		position[0] = 0;
+		position[1] = 0;
+	}
+}
+
+
+/*
+ *	Appends count elements of an unchanged operation starting at offset, or
+ *	the whole operation if count is negative, moved by shift on the changed
+ *	side.
+ */
+void
+IncrementalDiff::_AppendPart(const DiffOperation& operation, int offset, int count, int shift)
+{
+	DiffOperation part = operation;
+	if (count >= 0) {
+		part.from0 += offset;
+		part.from1 += offset;
+		part.count0 = count;
+		part.count1 = count;
+	}
+	if (fSeqNo == 0)
+		part.from0 += shift;
+	else
+		part.from1 += shift;
+	fScript.Append(part);
+}
+
+
+void
+IncrementalDiff::_DetectAll(const Sequences* sequences)
+{
+	_PassLimits(*fEngine);
+	fEngine->SetSink(&fScript);
+	fEngine->Detect(sequences);
+	if (fEngine->IsApproximate())
+		_SetApproximate();
+
+	fScript.Flush();
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef INCREMENTALDIFF_H
+#define INCREMENTALDIFF_H
+
+#include <vector>
+
+#include "DiffEngine.h"
+#include "DiffScript.h"
+
+
+/*
+ *	Brings the edit script of a previous comparison up to date after the
+ *	elements [begin, previousEnd) of one sequence were replaced by
+ *	[begin, end). Only the part of the script between the nearest points at
+ *	which both sequences were still in step is detected again, with the
+ *	engine given to the constructor; the operations around it are copied and
+ *	shifted.
+ */
+class IncrementalDiff : public DiffEngine {
+public:
+	typedef std::vector<DiffOperation>	OperationVector;
+
+						IncrementalDiff(DiffEngine* engine);
+	virtual				~IncrementalDiff();
+
+			void		SetPrevious(const OperationVector& operations, int seqNo,
+							int begin, int previousEnd, int end);
+
+	virtual	void			Detect(const Sequences* sequences);
+	virtual	const DiffOperation*	GetOperationAt(int index) const
+								{ return fScript.GetOperationAt(index); }
+
+private:
+	// the position offset elements into operation opIndex
+	struct Point {
+		int		opIndex;
+		int		offset;
+	};
+
+			Point		_FindStart() const;
+			Point		_FindEnd() const;
+			void		_GetPosition(const Point& point, int position[2]) const;
+			void		_AppendPart(const DiffOperation& operation, int offset, int count,
+							int shift);
+			void		_DetectAll(const Sequences* sequences);
+
+private:
+			DiffEngine*	fEngine;
+			DiffScript	fScript;
+		OperationVector	fPrevious;
+			int			fSeqNo;
+			int			fBegin;
+			int			fPreviousEnd;
+			int			fEnd;
+};
+
+#endif // INCREMENTALDIFF_H
@@ -0,0 +1,280 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "LineIndexCache.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <new>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+
+const uint64_t LineIndexCache::kDefaultSizeLimit;
+const off_t LineIndexCache::kMinFileSize;
+
+static const uint32_t kCacheMagic = 'PDLI';
+static const uint32_t kCacheVersion = 1;
+static const uint32_t kByteOrderMark = 0x01020304;
+static const uint32_t kHasFingerprints = 0x1;
+
+static const char kTemporaryPrefix[] = "tmp-";
+
+
+struct cache_header {
+	uint32_t	magic;
+	uint32_t	version;
+	uint32_t	byteOrder;		//< entries are only read on the same platform
+	uint32_t	offsetSize;		//< sizeof(size_t) of the writer
+	uint64_t	device;
+	uint64_t	inode;
+	uint64_t	size;
+	int64_t		modifiedSeconds;
+	int64_t		modifiedNanoseconds;
+	uint64_t	lineCount;
+	uint32_t	flags;
+	uint32_t	reserved;
+};
+
+
+struct cache_entry {
+	std::string	path;
+	time_t		lastUsed;
+	off_t		size;
+
+	bool operator<(const cache_entry& other) const
+		{ return lastUsed < other.lastUsed; }
+};
+
+
+static bool
+read_fully(int fd, void* data, size_t size)
+{
+	char* ptr = static_cast<char*>(data);
+	while (size > 0) {
+		ssize_t bytesRead = read(fd, ptr, size);
+		if (bytesRead < 0 && errno == EINTR)
+			continue;
+		if (bytesRead <= 0)
+			return false;
+		ptr += bytesRead;
+		size -= bytesRead;
+	}
+	return true;
+}
+
+
+static bool
+write_fully(int fd, const void* data, size_t size)
+{
+	const char* ptr = static_cast<const char*>(data);
+	while (size > 0) {
+		ssize_t bytesWritten = write(fd, ptr, size);
+		if (bytesWritten < 0 && errno == EINTR)
+			continue;
+		if (bytesWritten <= 0)
+			return false;
+		ptr += bytesWritten;
+		size -= bytesWritten;
+	}
+	return true;
+}
+
+
+static void
+make_header(const struct stat& st, size_t lineCount, bool withFingerprints,
+	cache_header& header)
+{
+	memset(&header, 0, sizeof(header));
+	header.magic = kCacheMagic;
+	header.version = kCacheVersion;
+	header.byteOrder = kByteOrderMark;
+	header.offsetSize = sizeof(size_t);
+	header.device = st.st_dev;
+	header.inode = st.st_ino;
+	header.size = st.st_size;
+	header.modifiedSeconds = st.st_mtim.tv_sec;
+	header.modifiedNanoseconds = st.st_mtim.tv_nsec;
+	header.lineCount = lineCount;
+	header.flags = withFingerprints ? kHasFingerprints : 0;
+}
+
+
+LineIndexCache::LineIndexCache(const char* directory, uint64_t sizeLimit)
+	:
+	fDirectory(directory),
+	fSizeLimit(sizeLimit)
+{
+	pthread_mutex_init(&fEvictLock, NULL);
+	mkdir(directory, 0755);
+}
+
+
+LineIndexCache::~LineIndexCache()
+{
+	pthread_mutex_destroy(&fEvictLock);
+}
+
+
+/*
+ *	Fills in the line table of the file described by st, and its fingerprints
+ *	if withFingerprints is set. Returns false if there is no valid entry.
+ */
+bool
+LineIndexCache::Lookup(const struct stat& st, bool withFingerprints,
+	std::vector<size_t>& lineEnds, std::vector<uint64_t>& fingerprints)
+{
+	if (!S_ISREG(st.st_mode) || st.st_size < kMinFileSize)
+		return false;
+
+	std::string path = _EntryPath(st);
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	cache_header header;
+	cache_header expected;
+	bool valid = read_fully(fd, &header, sizeof(header));
+	if (valid) {
+		make_header(st, header.lineCount, withFingerprints, expected);
+		expected.flags = header.flags;
+		valid = memcmp(&header, &expected, sizeof(header)) == 0
+			&& (!withFingerprints || (header.flags & kHasFingerprints) != 0)
+			&& header.lineCount > 0 && header.lineCount <= header.size;
+	}
+
+	try {
+		if (valid) {
+			lineEnds.resize(header.lineCount);
+			valid = read_fully(fd, &lineEnds[0], header.lineCount * sizeof(size_t));
+		}
+		if (valid && withFingerprints) {
+			fingerprints.resize(header.lineCount);
+			valid = read_fully(fd, &fingerprints[0], header.lineCount * sizeof(uint64_t));
+		}
+	} catch (std::bad_alloc&) {
+		valid = false;
+	}
+	close(fd);
+
+	// a damaged entry must not send a line past the end of the file
+	size_t index;
+	for (index = 0; valid && index < lineEnds.size(); index++) {
+		if (lineEnds[index] <= (index > 0 ? lineEnds[index - 1] : 0))
+			valid = false;
+	}
+	if (valid && lineEnds.back() != static_cast<uint64_t>(st.st_size))
+		valid = false;
+
+	if (!valid) {
+		std::vector<size_t>().swap(lineEnds);
+		std::vector<uint64_t>().swap(fingerprints);
+		return false;
+	}
+
+	// the modification time of an entry is the time it was last used
+	utimes(path.c_str(), NULL);
+	return true;
+}
+
+
+/*
+ *	Writes the entry for the file described by st. Failures are ignored, the
+ *	file is just scanned again next time.
+ */
+void
+LineIndexCache::Store(const struct stat& st, const std::vector<size_t>& lineEnds,
+	const std::vector<uint64_t>& fingerprints)
+{
+	if (!S_ISREG(st.st_mode) || st.st_size < kMinFileSize || lineEnds.empty())
+		return;
+
+	bool withFingerprints = fingerprints.size() == lineEnds.size();
+	cache_header header;
+	make_header(st, lineEnds.size(), withFingerprints, header);
+
+	// write under a temporary name, so readers never see a partial entry
+	std::string temporaryPath = fDirectory + "/" + kTemporaryPrefix + "XXXXXX";
+	std::vector<char> pathBuffer(temporaryPath.begin(), temporaryPath.end());
+	pathBuffer.push_back('\0');
+	int fd = mkstemp(&pathBuffer[0]);
+	if (fd < 0)
+		return;
+
+	bool written = write_fully(fd, &header, sizeof(header))
+		&& write_fully(fd, &lineEnds[0], lineEnds.size() * sizeof(size_t))
+		&& (!withFingerprints
+			|| write_fully(fd, &fingerprints[0], fingerprints.size() * sizeof(uint64_t)));
+	close(fd);
+
+	if (!written || rename(&pathBuffer[0], _EntryPath(st).c_str()) != 0) {
+		unlink(&pathBuffer[0]);
+		return;
+	}
+
+	_Evict();
+}
+
+
+std::string
+LineIndexCache::_EntryPath(const struct stat& st) const
+{
+	// one entry per file, a newer version replaces the older one
+	char name[64];
+	snprintf(name, sizeof(name), "%llx-%llx",
+		static_cast<unsigned long long>(st.st_dev),
+		static_cast<unsigned long long>(st.st_ino));
+	return fDirectory + "/" + name;
+}
+
+
+/*
+ *	Removes the least recently used entries until the directory fits into the
+ *	size limit again.
+ */
+void
+LineIndexCache::_Evict()
+{
+	pthread_mutex_lock(&fEvictLock);
+
+	DIR* dir = opendir(fDirectory.c_str());
+	if (dir == NULL) {
+		pthread_mutex_unlock(&fEvictLock);
+		return;
+	}
+
+	std::vector<cache_entry> entries;
+	uint64_t totalSize = 0;
+	struct dirent* dirent;
+	while ((dirent = readdir(dir)) != NULL) {
+		if (dirent->d_name[0] == '.'
+			|| strncmp(dirent->d_name, kTemporaryPrefix, strlen(kTemporaryPrefix)) == 0)
+			continue;
+
+		cache_entry entry;
+		entry.path = fDirectory + "/" + dirent->d_name;
+		struct stat st;
+		if (stat(entry.path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+			continue;
+		entry.lastUsed = st.st_mtime;
+		entry.size = st.st_size;
+		entries.push_back(entry);
+		totalSize += st.st_size;
+	}
+	closedir(dir);
+
+	std::sort(entries.begin(), entries.end());
+	size_t index;
+	for (index = 0; index < entries.size() && totalSize > fSizeLimit; index++) {
+		if (unlink(entries[index].path.c_str()) == 0)
+			totalSize -= entries[index].size;
+	}
+
+	pthread_mutex_unlock(&fEvictLock);
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef LINEINDEXCACHE_H
+#define LINEINDEXCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/stat.h>
+
+
+/*
+ *	Keeps the line end offsets and fingerprints of large files in a directory,
+ *	one cache file per file, so that loading an unchanged file again can skip
+ *	the scan for line breaks. An entry is only valid for the same device,
+ *	inode, size and modification time. Once the directory grows beyond its
+ *	size limit, the least recently used entries are removed.
+ *	All methods may be called from several threads at once.
+ */
+class LineIndexCache {
+public:
+						LineIndexCache(const char* directory,
+							uint64_t sizeLimit = kDefaultSizeLimit);
+						~LineIndexCache();
+
+			bool		Lookup(const struct stat& st, bool withFingerprints,
+							std::vector<size_t>& lineEnds,
+							std::vector<uint64_t>& fingerprints);
+			void		Store(const struct stat& st,
+							const std::vector<size_t>& lineEnds,
+							const std::vector<uint64_t>& fingerprints);
+
+	static const uint64_t	kDefaultSizeLimit = 256 * 1024 * 1024;
+
+	// smaller files are scanned faster than their entry would be read
+	static const off_t		kMinFileSize = 1024 * 1024;
+
+private:
+			std::string	_EntryPath(const struct stat& st) const;
+			void		_Evict();
+
+private:
+			std::string	fDirectory;
+			uint64_t	fSizeLimit;
+			pthread_mutex_t	fEvictLock;
+};
+
+#endif // LINEINDEXCACHE_H
@@ -0,0 +1,284 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "LineInterner.h"
+#include "Exception.h"
+#include "LineSeparatedText.h"
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+
+static const uint32_t kEmptySlot = 0xffffffff;
+static const uint32_t kInitialSlotCount = 1024;
+static const uint32_t kNoIDs = 0;
+
+
+LineInterner::LineInterner()
+{
+	fSlots = NULL;
+	fSlotMask = 0;
+}
+
+
+LineInterner::~LineInterner()
+{
+	Clear();
+}
+
+
+void
+LineInterner::Clear()
+{
+	free(fSlots);
+	fSlots = NULL;
+	fSlotMask = 0;
+	fLines.clear();
+}
+
+
+uint32_t
+LineInterner::Intern(const Substring& line)
+{
+	// keep the load factor at or below 1/2
+	if (fSlots == NULL)
+		_Rehash(kInitialSlotCount);
+	else if ((fLines.size() + 1) * 2 > fSlotMask + 1)
+		_Rehash((fSlotMask + 1) * 2);
+
+	uint32_t hash = HashLine(line);
+	uint32_t index = hash & fSlotMask;
+	while (true) {
+		Slot& slot = fSlots[index];
+		if (slot.id == kEmptySlot) {
+			slot.hash = hash;
+			slot.id = fLines.size();
+			fLines.push_back(line);
+			return slot.id;
+		}
+		if (slot.hash == hash && fLines[slot.id] == line)
+			return slot.id;
+		index = (index + 1) & fSlotMask;
+	}
+}
+
+
+/*
+ *	Drops every line that does not occur in one of the texts, whose lines
+ *	were interned as ids, and numbers the remaining ones densely again; the
+ *	ids are updated in place. Afterwards all IDs refer to the lines of these
+ *	texts, so any other text that was interned may go away.
+ */
+void
+LineInterner::Retain(const LineSeparatedText* const* texts, std::vector<uint32_t>* ids,
+	int textCount)
+{
+	std::vector<uint32_t> remap(fLines.size(), kEmptySlot);
+	SubstringVector lines;
+	int textIndex;
+	for (textIndex = 0; textIndex < textCount; textIndex++) {
+		std::vector<uint32_t>& textIDs = ids[textIndex];
+		size_t index;
+		for (index = 0; index < textIDs.size(); index++) {
+			uint32_t& id = remap[textIDs[index]];
+			if (id == kEmptySlot) {
+				id = lines.size();
+				lines.push_back(texts[textIndex]->GetLineAt(index));
+			}
+			textIDs[index] = id;
+		}
+	}
+
+	// the stored hashes are still valid, only the IDs change
+	uint32_t slotIndex;
+	for (slotIndex = 0; fSlots != NULL && slotIndex <= fSlotMask; slotIndex++) {
+		Slot& slot = fSlots[slotIndex];
+		if (slot.id != kEmptySlot)
+			slot.id = remap[slot.id];
+	}
+	fLines.swap(lines);
+	if (fSlots != NULL)
+		_Rehash(fSlotMask + 1);
+}
+
+
+/*static*/ uint32_t
+LineInterner::HashLine(const Substring& line)
+{
+	// texts that were loaded with fingerprints need not be hashed again
+	uint64_t fingerprint = line.Fingerprint();
+	if (fingerprint == Substring::kNoFingerprint)
+		fingerprint = Substring::ComputeFingerprint(line.Begin(), line.End());
+	return static_cast<uint32_t>(fingerprint);
+}
+
+
+void
+LineInterner::_Rehash(uint32_t slotCount)
+{
+	Slot* slots = static_cast<Slot*>(malloc(slotCount * sizeof(Slot)));
+	if (slots == NULL)
+		MemoryException::Throw();
+
+	uint32_t index;
+	for (index = 0; index < slotCount; index++)
+		slots[index].id = kEmptySlot;
+
+	uint32_t mask = slotCount - 1;
+	if (fSlots != NULL) {
+		for (index = 0; index <= fSlotMask; index++) {
+			const Slot& slot = fSlots[index];
+			if (slot.id == kEmptySlot)
+				continue;
+			uint32_t newIndex = slot.hash & mask;
+			while (slots[newIndex].id != kEmptySlot)
+				newIndex = (newIndex + 1) & mask;
+			slots[newIndex] = slot;
+		}
+		free(fSlots);
+	}
+
+	fSlots = slots;
+	fSlotMask = mask;
+}
+
+
+InternedSequences::InternedSequences(LineInterner* interner)
+{
+	fInterner = interner;
+	fTexts[0] = NULL;
+	fTexts[1] = NULL;
+}
+
+
+InternedSequences::~InternedSequences()
+{
+}
+
+
+void
+InternedSequences::Clear()
+{
+	int seqNo;
+	for (seqNo = 0; seqNo < 2; seqNo++) {
+		fTexts[seqNo] = NULL;
+		fIDs[seqNo].clear();
+		fCounts[seqNo].clear();
+	}
+	fInterner->Clear();
+}
+
+
+void
+InternedSequences::Assign(int seqNo, const LineSeparatedText& text)
+{
+	fTexts[seqNo] = &text;
+
+	IDVector& ids = fIDs[seqNo];
+	CountVector& counts = fCounts[seqNo];
+
+	int lineCount = text.GetLineCount();
+	ids.resize(lineCount);
+	counts.clear();
+
+	int index;
+	for (index = 0; index < lineCount; index++) {
+		uint32_t id = fInterner->Intern(text.GetLineAt(index));
+		ids[index] = id;
+		if (id >= counts.size())
+			counts.resize(fInterner->CountIDs(), 0);
+		counts[id]++;
+	}
+}
+
+
+/*
+ *	Replaces the lines of one side, keeping the IDs of the other side, which
+ *	is not interned again. The previous text of the side must still be
+ *	loaded; once this returns, the interner no longer refers to it.
+ *	headCount and tailCount receive the number of lines at the start and at
+ *	the end that are the same in the previous and in the new text.
+ */
+void
+InternedSequences::Reassign(int seqNo, const LineSeparatedText& text, int* headCount,
+	int* tailCount)
+{
+	IDVector previousIDs;
+	previousIDs.swap(fIDs[seqNo]);
+	Assign(seqNo, text);
+
+	const IDVector& ids = fIDs[seqNo];
+	size_t commonLength = std::min(previousIDs.size(), ids.size());
+	size_t head = 0;
+	size_t tail = 0;
+	if (commonLength > 0) {
+		head = CountEqualPrefix(&previousIDs[0], &ids[0], commonLength);
+		tail = CountEqualSuffix(&previousIDs[previousIDs.size() - (commonLength - head)],
+			&ids[ids.size() - (commonLength - head)], commonLength - head);
+	}
+	if (headCount != NULL)
+		*headCount = head;
+	if (tailCount != NULL)
+		*tailCount = tail;
+
+	// drop the lines that only the previous text had; a side without a
+	// text has no IDs
+	fInterner->Retain(fTexts, fIDs, 2);
+
+	int side;
+	for (side = 0; side < 2; side++) {
+		CountVector& counts = fCounts[side];
+		counts.assign(fInterner->CountIDs(), 0);
+		size_t index;
+		for (index = 0; index < fIDs[side].size(); index++)
+			counts[fIDs[side][index]]++;
+	}
+}
+
+
+/*
+ *	Exchanges both sides, with their texts, for a view that switched its
+ *	files. The interner is not touched.
+ */
+void
+InternedSequences::SwapSides()
+{
+	std::swap(fTexts[0], fTexts[1]);
+	fIDs[0].swap(fIDs[1]);
+	fCounts[0].swap(fCounts[1]);
+}
+
+
+int
+InternedSequences::GetLength(int seqNo) const
+{
+	switch (seqNo) {
+		case 0:
+		case 1:
+			return fIDs[seqNo].size();
+		default:
+			return 0;
+	}
+}
+
+
+const uint32_t*
+InternedSequences::GetIDs(int seqNo) const
+{
+	if (fIDs[seqNo].empty())
+		return &kNoIDs;
+	return &fIDs[seqNo][0];
+}
+
+
+int
+InternedSequences::CountOccurrences(int seqNo, uint32_t id) const
+{
+	const CountVector& counts = fCounts[seqNo];
+	if (id >= counts.size())
+		return 0;
+	return counts[id];
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef LINEINTERNER_H
+#define LINEINTERNER_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "NPDiff.h"
+#include "Substring.h"
+
+class LineSeparatedText;
+
+
+/*
+ *	Gives every distinct line a dense 32-bit ID, so that two lines are equal
+ *	if and only if their IDs are equal. The interner only refers to the text
+ *	buffers, it does not copy them; the texts must outlive it.
+ */
+class LineInterner {
+public:
+						LineInterner();
+	virtual				~LineInterner();
+
+			void		Clear();
+			uint32_t	Intern(const Substring& line);
+			void		Retain(const LineSeparatedText* const* texts,
+							std::vector<uint32_t>* ids, int textCount);
+
+			uint32_t	CountIDs() const { return fLines.size(); }
+	const Substring&	GetLineForID(uint32_t id) const { return fLines[id]; }
+
+	static	uint32_t	HashLine(const Substring& line);
+
+private:
+			void		_Rehash(uint32_t slotCount);
+
+private:
+	struct Slot {
+		uint32_t	hash;
+		uint32_t	id;		//< kEmptySlot if the slot is unused
+	};
+	typedef std::vector<Substring>	SubstringVector;
+
+			Slot*		fSlots;
+			uint32_t	fSlotMask;
+	SubstringVector		fLines;
+};
+
+
+/*
+ *	Sequences made of the interned lines of two texts. The ID arrays and the
+ *	per-side occurrence counts are available to any consumer, not only to
+ *	the diff engines.
+ */
+class InternedSequences : public Sequences {
+public:
+						InternedSequences(LineInterner* interner);
+	virtual				~InternedSequences();
+
+			void		Clear();
+			void		Assign(int seqNo, const LineSeparatedText& text);
+			void		Reassign(int seqNo, const LineSeparatedText& text,
+							int* headCount = NULL, int* tailCount = NULL);
+			void		SwapSides();
+
+	virtual	int			GetLength(int seqNo) const;
+	virtual bool		IsEqual(int index0, int index1) const
+							{ return fIDs[0][index0] == fIDs[1][index1]; }
+	virtual	const uint32_t*	GetIDs(int seqNo) const;
+	virtual	uint32_t	GetIDLimit() const { return fInterner->CountIDs(); }
+
+			int			CountOccurrences(int seqNo, uint32_t id) const;
+			LineInterner*	GetInterner() const { return fInterner; }
+
+private:
+	typedef std::vector<uint32_t>	IDVector;
+	typedef std::vector<int>		CountVector;
+
+			LineInterner*	fInterner;
+	const	LineSeparatedText*	fTexts[2];
+			IDVector	fIDs[2];
+			CountVector	fCounts[2];
+};
+
+#endif // LINEINTERNER_H
@@ -8,17 +8,81 @@
  *
  */
 #include "LineSeparatedText.h"
+#include "DiffEngine.h"
 #include "Exception.h"
 #include "ExceptionCode.h"
+#include "LineIndexCache.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
 
-#include <File.h>
-#include <Path.h>
-
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <new>
+#include <stdint.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// read size for files that do not report their size
+static const size_t kReadChunkSize = 64 * 1024;
+
+// the largest single read, the lines read so far are split after each one
+static const size_t kMaxReadSize = 1024 * 1024;
+
+// smaller texts are split on the calling thread
+static const size_t kMinParallelSplitSize = 16 * 1024 * 1024;
+
+// splitting costs about the same per byte everywhere, so equal chunks take
+// equal time; a few per thread only make up for threads that start late or
+// share their CPU, and each boundary costs a search for the next line break
+static const int kChunksPerThread = 4;
+
+
+class LineSeparatedText::SplitTask : public PoolTask {
+public:
+	SplitTask(const char* buffer, const char* begin, const char* end,
+			DiffProgress* progress)
+		:
+		fBuffer(buffer),
+		fBegin(begin),
+		fEnd(end),
+		fProgress(progress),
+		fLineEnds(NULL),
+		fFingerprints(NULL),
+		fLineCount(0)
+	{
+	}
+
+	// counts the lines first, and stores them once fLineEnds is set
+	virtual void Run()
+	{
+		fLineCount = _SplitRange(fBuffer, fBegin, fEnd, fLineEnds, fFingerprints);
+		if (fLineEnds == NULL && fProgress != NULL)
+			fProgress->AddBytes(fEnd - fBegin);
+	}
+
+	const	char*		fBuffer;
+	const	char*		fBegin;
+	const	char*		fEnd;
+	DiffProgress*		fProgress;
+	size_t*				fLineEnds;
+	uint64_t*			fFingerprints;
+	size_t				fLineCount;
+};
+
 
 LineSeparatedText::LineSeparatedText()
 {
-	fLoadedBuffer = NULL;
+	fBuffer = NULL;
+	fBufferSize = 0;
+	fIsMapped = false;
+	fMapping = true;
+	fFingerprinting = false;
+	fIndexCache = NULL;
+	fProgress = NULL;
 }
 
 
@@ -28,55 +92,416 @@ LineSeparatedText::~LineSeparatedText()
 }
 
 
+/*
+ *	Regular files are mapped read-only, so the lines point straight into the
+ *	page cache. A mapping must not be read once its file has been truncated,
+ *	which raises SIGBUS, so texts kept while their files may be edited turn
+ *	mapping off and are copied instead. Anything that cannot be mapped
+ *	(pipes, devices, file systems without mmap support) is read into a
+ *	malloc()ed buffer, and split as it arrives, and so is a copy unless it
+ *	is large enough to be split in parallel, or the index cache knows it.
+ *	Large mapped or copied texts are split into lines on the given pool, or
+ *	on a pool of their own when none is given, unless the index cache
+ *	already knows them.
+ *	With a progress set, the bytes are counted as they are read or split,
+ *	and a canceled progress ends the load with an EXCEPTION_CANCELED.
+ */
 void
-LineSeparatedText::Load(const BPath& path)
+LineSeparatedText::Load(const char* path, ThreadPool* pool)
 {
 	Unload();
 
-	BFile file;
-	status_t st = file.SetTo(path.Path(), B_READ_ONLY);
-	if (B_NO_ERROR != st)
-		throw new FileException(EXCEPTION_FILE_OPEN, path, st);
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		throw new FileException(EXCEPTION_FILE_OPEN, path, errno);
 
-	off_t size;
-	file.GetSize(&size);
-	uint32 size32 = static_cast<uint32>(size);
-	fLoadedBuffer = static_cast<char*>(malloc(size32));
-	if (fLoadedBuffer == NULL)
-		MemoryException::Throw();
-	file.Read(fLoadedBuffer, size32);
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		int error = errno;
+		close(fd);
+		throw new FileException(EXCEPTION_FILE_OPEN, path, error);
+	}
+
+	size_t size = 0;
+	if (S_ISREG(st.st_mode)) {
+		if (static_cast<uint64_t>(st.st_size) > SIZE_MAX) {
+			close(fd);
+			MemoryException::Throw();
+		}
+
+		size = static_cast<size_t>(st.st_size);
+		if (size > 0 && fMapping) {
+			void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping != MAP_FAILED) {
+				fBuffer = static_cast<const char*>(mapping);
+				fBufferSize = size;
+				fIsMapped = true;
+#ifdef POSIX_MADV_WILLNEED
+				// start reading ahead, the split follows behind
+				posix_madvise(mapping, size, POSIX_MADV_WILLNEED);
+#endif
+			}
+		}
+	}
+
+	// whether the whole file is in the buffer, still to be split
+	bool isWhole = fIsMapped;
+	bool isCopied = false;
+	bool isIndexed = false;
+	LineIndexCache* indexCache = fIndexCache;
+	try {
+		if (!isWhole && size > 0 && !fMapping) {
+			isIndexed = indexCache != NULL
+				&& indexCache->Lookup(st, fFingerprinting, fLineEnds, fFingerprints);
+			if (isIndexed || _IsSplitInParallel(size, pool)) {
+				_CopyFile(fd, size, path);
+				isWhole = true;
+			} else
+				_ReadFile(fd, size, path);
+			isCopied = true;
+
+			// the index of a file changed while it was read may not fit
+			struct stat copied;
+			if (fstat(fd, &copied) != 0 || copied.st_size != st.st_size
+				|| copied.st_mtim.tv_sec != st.st_mtim.tv_sec
+				|| copied.st_mtim.tv_nsec != st.st_mtim.tv_nsec || fBufferSize != size) {
+				indexCache = NULL;
+				if (isIndexed) {
+					OffsetVector().swap(fLineEnds);
+					FingerprintVector().swap(fFingerprints);
+					isIndexed = false;
+				}
+			}
+		} else if (!isWhole)
+			_ReadFile(fd, S_ISREG(st.st_mode) ? st.st_size : 0, path);
+	} catch (...) {
+		close(fd);
+		Unload();
+		throw;
+	}
+	close(fd);
+
+	if (!isWhole) {
+		// a copy split as it was read
+		if (isCopied && indexCache != NULL)
+			indexCache->Store(st, fLineEnds, fFingerprints);
+		return;
+	}
+
+	if (isIndexed
+		|| (!isCopied && indexCache != NULL
+			&& indexCache->Lookup(st, fFingerprinting, fLineEnds, fFingerprints))) {
+		if (fProgress != NULL && !isCopied)
+			fProgress->AddBytes(fBufferSize);
+		return;
+	}
 
-	_SplitBuffer(size32);
+	try {
+		// the bytes of a copy have been counted as they were read
+		_SplitBuffer(pool, !isCopied);
+	} catch (...) {
+		Unload();
+		throw;
+	}
+	if (indexCache != NULL)
+		indexCache->Store(st, fLineEnds, fFingerprints);
 }
 
 
 void
 LineSeparatedText::Unload()
 {
-	if (fLoadedBuffer != NULL) {
-		free(fLoadedBuffer);
-		fLoadedBuffer = NULL;
+	if (fBuffer != NULL) {
+		if (fIsMapped)
+			munmap(const_cast<char*>(fBuffer), fBufferSize);
+		else
+			free(const_cast<char*>(fBuffer));
+		fBuffer = NULL;
+	}
+	fBufferSize = 0;
+	fIsMapped = false;
+	OffsetVector().swap(fLineEnds);
+	FingerprintVector().swap(fFingerprints);
+}
+
+
+/*
+ *	Reads the file to its end, whatever size it claimed to have. The lines
+ *	that are complete are split after every read, while the kernel is
+ *	already reading ahead.
+ */
+void
+LineSeparatedText::_ReadFile(int fd, size_t sizeHint, const char* path)
+{
+	size_t capacity = (sizeHint > 0) ? sizeHint : kReadChunkSize;
+	size_t length = 0;
+	size_t splitLength = 0;
+	char* buffer = static_cast<char*>(malloc(capacity));
+	if (buffer == NULL)
+		MemoryException::Throw();
+
+	try {
+		while (true) {
+			if (length == capacity) {
+				char* grown = (capacity <= SIZE_MAX / 2)
+					? static_cast<char*>(realloc(buffer, capacity * 2)) : NULL;
+				if (grown == NULL)
+					MemoryException::Throw();
+				buffer = grown;
+				capacity *= 2;
+			}
+
+			size_t readSize = capacity - length;
+			if (readSize > kMaxReadSize)
+				readSize = kMaxReadSize;
+			ssize_t bytesRead = read(fd, buffer + length, readSize);
+			if (bytesRead < 0) {
+				if (errno == EINTR)
+					continue;
+				throw new FileException(EXCEPTION_FILE_READ, path, errno);
+			}
+			if (bytesRead == 0)
+				break;
+			if (fProgress != NULL)
+				fProgress->AddBytes(bytesRead);
+			_CheckCanceled();
+
+			// only the new bytes can hold a new line end; a CR at the very
+			// end may still get its LF
+			size_t splitEnd = length + bytesRead;
+			size_t scanBegin = (length > splitLength) ? length - 1 : splitLength;
+			length += bytesRead;
+			while (splitEnd > scanBegin) {
+				char ch = buffer[splitEnd - 1];
+				if (ch == '\n' || (ch == '\r' && splitEnd < length))
+					break;
+				splitEnd--;
+			}
+			if (splitEnd > scanBegin) {
+				_AppendLines(buffer, splitLength, splitEnd);
+				splitLength = splitEnd;
+			}
+		}
+
+		_AppendLines(buffer, splitLength, length);
+	} catch (...) {
+		free(buffer);
+		OffsetVector().swap(fLineEnds);
+		FingerprintVector().swap(fFingerprints);
+		throw;
+	}
+
+	fBuffer = buffer;
+	fBufferSize = length;
+}
+
+
+/*
+ *	Reads a regular file of the given size whole, to be split afterwards like
+ *	a mapped one, or not at all if the index cache knows it. A file that has shrunk in the meantime is read to its new
+ *	end, one that has grown only up to its former size.
+ */
+void
+LineSeparatedText::_CopyFile(int fd, size_t size, const char* path)
+{
+	char* buffer = static_cast<char*>(malloc(size));
+	if (buffer == NULL)
+		MemoryException::Throw();
+
+	size_t length = 0;
+	try {
+		while (length < size) {
+			size_t readSize = std::min(size - length, kMaxReadSize);
+			ssize_t bytesRead = read(fd, buffer + length, readSize);
+			if (bytesRead < 0) {
+				if (errno == EINTR)
+					continue;
+				throw new FileException(EXCEPTION_FILE_READ, path, errno);
+			}
+			if (bytesRead == 0)
+				break;
+			length += bytesRead;
+			if (fProgress != NULL)
+				fProgress->AddBytes(bytesRead);
+			_CheckCanceled();
+		}
+	} catch (...) {
+		free(buffer);
+		throw;
 	}
-	fLines.clear();
+
+	fBuffer = buffer;
+	fBufferSize = length;
+}
+
+
+/*
+ *	Adds the lines in [begin, end) of buffer to the line table.
+ */
+void
+LineSeparatedText::_AppendLines(const char* buffer, size_t begin, size_t end)
+{
+	size_t lineCount = _SplitRange(buffer, buffer + begin, buffer + end, NULL, NULL);
+	if (lineCount == 0)
+		return;
+
+	size_t firstLine = fLineEnds.size();
+	_AllocateIndex(firstLine + lineCount);
+	_SplitRange(buffer, buffer + begin, buffer + end, &fLineEnds[0] + firstLine,
+		fFingerprinting ? &fFingerprints[0] + firstLine : NULL);
 }
 
 
+/*
+ *	The line table holds the end offset of every line and is allocated once,
+ *	after a counting pass, so building it never reallocates.
+ *	The buffer is cut into chunks that each start at the beginning of a line,
+ *	which are counted and then indexed independently. A boundary is moved
+ *	past the next line break, and past the LF of a CR + LF pair, so no chunk
+ *	depends on its neighbours and the table is the same as a sequential split.
+ */
 void
-LineSeparatedText::_SplitBuffer(uint32 size)
+LineSeparatedText::_SplitBuffer(ThreadPool* pool, bool countBytes)
 {
-	char* ptr = fLoadedBuffer;
-	char* endBuffer = fLoadedBuffer + size;
-
-	char* strBegin = ptr;
-	for (; ptr < endBuffer; ptr++) {
-		if (*ptr == '\n') {
-			fLines.push_back(Substring(strBegin, ptr + 1));
-			strBegin = ptr + 1;
-		} else if (*ptr == '\r' && (ptr + 1 >= endBuffer || *(ptr + 1) != '\n')) {
-			fLines.push_back(Substring(strBegin, ptr + 1));
-			strBegin = ptr + 1;
+	DiffProgress* progress = countBytes ? fProgress : NULL;
+
+	if (!_IsSplitInParallel(fBufferSize, pool)) {
+		const char* endBuffer = fBuffer + fBufferSize;
+		size_t lineCount = _SplitRange(fBuffer, fBuffer, endBuffer, NULL, NULL);
+		if (progress != NULL)
+			progress->AddBytes(fBufferSize);
+		_CheckCanceled();
+		_AllocateIndex(lineCount);
+		if (!fLineEnds.empty()) {
+			_SplitRange(fBuffer, fBuffer, endBuffer, &fLineEnds[0],
+				fFingerprinting ? &fFingerprints[0] : NULL);
 		}
+		return;
+	}
+
+	ThreadPool* ownPool = NULL;
+	if (pool == NULL)
+		pool = ownPool = new ThreadPool();
+
+	const char* endBuffer = fBuffer + fBufferSize;
+	size_t chunkCount = pool->CountThreads() * kChunksPerThread;
+	size_t chunkSize = fBufferSize / chunkCount + 1;
+
+	std::vector<SplitTask*> tasks;
+	TaskGroup group;
+	const char* chunkBegin = fBuffer;
+	while (chunkBegin < endBuffer) {
+		const char* chunkEnd = endBuffer;
+		if (static_cast<size_t>(endBuffer - chunkBegin) > chunkSize) {
+			chunkEnd = FindLineBreak(chunkBegin + chunkSize, endBuffer);
+			if (chunkEnd < endBuffer) {
+				if (*chunkEnd == '\r' && chunkEnd + 1 < endBuffer && *(chunkEnd + 1) == '\n')
+					chunkEnd++;
+				chunkEnd++;
+			}
+		}
+
+		SplitTask* task = new SplitTask(fBuffer, chunkBegin, chunkEnd, progress);
+		tasks.push_back(task);
+		pool->Submit(task, &group);
+		chunkBegin = chunkEnd;
+	}
+	pool->Wait(&group);
+
+	size_t lineCount = 0;
+	size_t index;
+	for (index = 0; index < tasks.size(); index++)
+		lineCount += tasks[index]->fLineCount;
+
+	try {
+		_CheckCanceled();
+		_AllocateIndex(lineCount);
+	} catch (...) {
+		for (index = 0; index < tasks.size(); index++)
+			delete tasks[index];
+		delete ownPool;
+		throw;
+	}
+
+	// every chunk writes its part of the table in place
+	size_t firstLine = 0;
+	for (index = 0; index < tasks.size(); index++) {
+		SplitTask* task = tasks[index];
+		task->fLineEnds = &fLineEnds[0] + firstLine;
+		if (fFingerprinting)
+			task->fFingerprints = &fFingerprints[0] + firstLine;
+		firstLine += task->fLineCount;
+		pool->Submit(task, &group);
+	}
+	pool->Wait(&group);
+
+	for (index = 0; index < tasks.size(); index++)
+		delete tasks[index];
+	delete ownPool;
+}
+
+
+/*static*/ bool
+LineSeparatedText::_IsSplitInParallel(size_t size, ThreadPool* pool)
+{
+	int threadCount = (pool != NULL) ? pool->CountThreads() : ThreadPool::CountCPUs();
+	return size >= kMinParallelSplitSize && threadCount >= 2;
+}
+
+
+void
+LineSeparatedText::_AllocateIndex(size_t lineCount)
+{
+	try {
+		fLineEnds.resize(lineCount);
+		if (fFingerprinting)
+			fFingerprints.resize(lineCount);
+	} catch (std::bad_alloc&) {
+		MemoryException::Throw();
+	}
+}
+
+
+void
+LineSeparatedText::_CheckCanceled() const
+{
+	if (fProgress != NULL && fProgress->IsCanceled())
+		throw new Exception(EXCEPTION_CANCELED);
+}
+
+
+/*
+ *	Stores the end offsets, relative to buffer, of the lines in [begin, end)
+ *	into lineEnds, unless it is NULL, and returns the number of lines.
+ *	The fingerprint of each line is taken right after its end is found, while
+ *	the line is still in the cache.
+ */
+size_t
+LineSeparatedText::_SplitRange(const char* buffer, const char* begin, const char* end,
+	size_t* lineEnds, uint64_t* fingerprints)
+{
+	// a line ends with LF, with CR + LF or with a CR that is not followed by LF
+	size_t lineCount = 0;
+	const char* strBegin = begin;
+	while (strBegin < end) {
+		const char* ptr = FindLineBreak(strBegin, end);
+		if (ptr == end)
+			break;
+		if (*ptr == '\r' && ptr + 1 < end && *(ptr + 1) == '\n')
+			ptr++;
+		if (lineEnds != NULL)
+			lineEnds[lineCount] = ptr + 1 - buffer;
+		if (fingerprints != NULL)
+			fingerprints[lineCount] = Substring::ComputeFingerprint(strBegin, ptr + 1);
+		lineCount++;
+		strBegin = ptr + 1;
+	}
+	if (strBegin < end) {
+		if (lineEnds != NULL)
+			lineEnds[lineCount] = end - buffer;
+		if (fingerprints != NULL)
+			fingerprints[lineCount] = Substring::ComputeFingerprint(strBegin, end);
+		lineCount++;
 	}
-	if (strBegin < endBuffer)
-		fLines.push_back(Substring(strBegin, endBuffer));
+	return lineCount;
 }
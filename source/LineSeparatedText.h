@@ -9,32 +9,75 @@
 #ifndef LINESEPARATEDTEXT_H
 #define LINESEPARATEDTEXT_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include <vector>
 
 #include "Substring.h"
 
-#include <Path.h>
-
+class DiffProgress;
+class LineIndexCache;
+class ThreadPool;
 
 class LineSeparatedText {
 public:
 						LineSeparatedText();
 	virtual				~LineSeparatedText();
 
-			void		Load(const BPath& path);
+			void		Load(const char* path, ThreadPool* pool = NULL);
 			void		Unload();
 
-			int			GetLineCount() const { return fLines.size(); }
-	const Substring&	GetLineAt(int index) const { return fLines[index]; }
+			void		SetFingerprinting(bool enabled)
+							{ fFingerprinting = enabled; }
+			void		SetMapping(bool enabled)
+							{ fMapping = enabled; }
+			void		SetIndexCache(LineIndexCache* cache)
+							{ fIndexCache = cache; }
+			void		SetProgress(DiffProgress* progress)
+							{ fProgress = progress; }
+			bool		HasFingerprints() const
+							{ return !fFingerprints.empty(); }
+
+			int			GetLineCount() const { return fLineEnds.size(); }
+			Substring	GetLineAt(int index) const;
 
 private:
-			void		_SplitBuffer(uint32 size);
+			void		_ReadFile(int fd, size_t sizeHint, const char* path);
+			void		_CopyFile(int fd, size_t size, const char* path);
+			void		_AppendLines(const char* buffer, size_t begin,
+							size_t end);
+			void		_SplitBuffer(ThreadPool* pool, bool countBytes);
+			void		_AllocateIndex(size_t lineCount);
+			void		_CheckCanceled() const;
 
 private:
-	typedef std::vector<Substring>	SubstringVector;
+	typedef std::vector<size_t>	OffsetVector;
+	typedef std::vector<uint64_t>	FingerprintVector;
+	class SplitTask;
+
+	static	bool		_IsSplitInParallel(size_t size, ThreadPool* pool);
+	static	size_t		_SplitRange(const char* buffer, const char* begin,
+							const char* end, size_t* lineEnds,
+							uint64_t* fingerprints);
 
-			char*		fLoadedBuffer;
-	SubstringVector		fLines;
+	const	char*		fBuffer;		//< mapping or malloc()ed copy
+			size_t		fBufferSize;
+			bool		fIsMapped;
+			bool		fMapping;		//< regular files may be mapped
+	OffsetVector		fLineEnds;		//< end offset of every line
+			bool		fFingerprinting;
+	FingerprintVector	fFingerprints;	//< empty unless fingerprinting
+	LineIndexCache*		fIndexCache;
+	DiffProgress*		fProgress;		//< NULL if not reported
 };
 
+
+inline Substring
+LineSeparatedText::GetLineAt(int index) const
+{
+	return Substring(fBuffer + (index > 0 ? fLineEnds[index - 1] : 0),
+		fBuffer + fLineEnds[index],
+		fFingerprints.empty() ? Substring::kNoFingerprint : fFingerprints[index]);
+}
+
 #endif // LINESEPARATEDTEXT_H
@@ -7,19 +7,10 @@
  *
  */
 #include "NPDiff.h"
-#include "Exception.h"
-#include "ExceptionCode.h"
-
-#include <stdlib.h>
-#include <string.h>
 
 
 NPDiff::NPDiff()
 {
-	fp = NULL;
-	fpBuffer = NULL;
-	sequences = NULL;
-	isSwapped = false;
 }
 
 
@@ -31,181 +22,65 @@ NPDiff::~NPDiff()
 void
 NPDiff::Detect(const Sequences* sequences)
 {
-	this->sequences = sequences;
-	isSwapped = (sequences->GetLength(0) > sequences->GetLength(1));
-	diffResult.clear();
+	diffResult.Clear();
+	diffResult.SetSink(GetSink());
+	_StartClock();
 
 	if (sequences == NULL)
 		return;
 
-	int m = getLength(0);
-	int n = getLength(1);
-	int delta = n - m;
-
-	fpBuffer = static_cast<int*>(malloc((m + n + 3) * sizeof(int)));
-	if (fpBuffer == NULL)
-		MemoryException::Throw();
-
-	memset(fpBuffer, 0, (m + n + 3) * sizeof(int));
-	fp = fpBuffer + m + 1;
-
-	int p;
-	for (p = 0; p < m; p++) // p < m は念のため
-	{
-		int k;
-		for (k = -p; k <= delta - 1; k++)
-			snake(k);
-		for (k = delta + p; k >= delta; k--)
-			snake(k);
-
-		int fpDataIndexDelta = fp[delta] - 1;
-		int fpDelta = (0 > fpDataIndexDelta) ? -1 : fpDataVector[fpDataIndexDelta].y;
-		if (fpDelta == n)
-			break;
-	}
+	int length0 = sequences->GetLength(0);
+	int length1 = sequences->GetLength(1);
 
-	makeResult();
+	// interned elements: comparing the IDs is enough
+	const uint32_t* ids0 = sequences->GetIDs(0);
+	const uint32_t* ids1 = sequences->GetIDs(1);
+	if (ids0 != NULL && ids1 != NULL)
+		detect(IDElements(ids0, ids1), length0, length1);
+	else
+		detect(SequencesElements(sequences), length0, length1);
 
-	free(fpBuffer);
-	fpBuffer = fp = NULL;
-	fpDataVector.clear();
+	diffResult.Flush();
 }
 
 
+template<class Elements>
 void
-NPDiff::snake(int k)
+NPDiff::detect(const Elements& elements, int length0, int length1)
 {
-	int fpDataIndex0 = fp[k - 1] - 1;
-	int fpDataIndex1 = fp[k + 1] - 1;
-
-	int fpY0 = (0 > fpDataIndex0) ? -1 : fpDataVector[fpDataIndex0].y;
-	int fpY1 = (0 > fpDataIndex1) ? -1 : fpDataVector[fpDataIndex1].y;
-
-	FPData data;
-	if (fpY0 + 1 > fpY1) {
-		data.y = fpY0 + 1;
-		data.prevFPDataIndex = fpDataIndex0;
+	// Strip the common head and tail first, only the window between them
+	// has to go through the O(NP) search.
+	int head, tail;
+	TrimCommonEnds(elements, 0, length0, 0, length1, head, tail);
+
+	int windowLength0 = length0 - head - tail;
+	int windowLength1 = length1 - head - tail;
+
+	if (head > 0)
+		OutputOperation(DiffOperation::NotChanged, 0, 0, head, head);
+
+	bool isApproximate;
+	if (windowLength0 > windowLength1) {
+		NPDiffCore<Elements, true> core(elements, this, GetMemoryBudget(), GetCostLimit(),
+			_Deadline(), GetProgress());
+		core.Detect(head, head, windowLength0, windowLength1);
+		isApproximate = core.IsApproximate();
 	} else {
-		data.y = fpY1;
-		data.prevFPDataIndex = fpDataIndex1;
-	}
-	data.x = data.y - k;
-
-	while (data.x < getLength(0) && data.y < getLength(1) && isEqual(data.x, data.y)) {
-		data.x++;
-		data.y++;
+		NPDiffCore<Elements, false> core(elements, this, GetMemoryBudget(), GetCostLimit(),
+			_Deadline(), GetProgress());
+		core.Detect(head, head, windowLength0, windowLength1);
+		isApproximate = core.IsApproximate();
 	}
+	if (isApproximate)
+		_SetApproximate();
 
-	fpDataVector.push_back(data);
-	fp[k] = static_cast<int>(fpDataVector.size());
+	if (tail > 0)
+		OutputOperation(DiffOperation::NotChanged, length0 - tail, length1 - tail, tail, tail);
 }
 
 
 void
-NPDiff::makeResult()
+NPDiff::OutputOperation(DiffOperation::Operator op, int from0, int from1, int count0, int count1)
 {
-	int fpDataIndex = fpDataVector.size() - 1;
-	const FPData* data = &fpDataVector[fpDataIndex];
-	int to0 = (isSwapped) ? data->y : data->x;
-	int to1 = (isSwapped) ? data->x : data->y;
-	fpDataIndex = data->prevFPDataIndex;
-	while (0 <= fpDataIndex) {
-		data = &fpDataVector[fpDataIndex];
-		fpDataIndex = data->prevFPDataIndex;
-		int from0 = (isSwapped) ? data->y : data->x;
-		int from1 = (isSwapped) ? data->x : data->y;
-		if (from1 - from0 < to1 - to0) {
-			if (from1 + 1 < to1) {
-				outputOperation(DiffOperation::NotChanged, from0, from1 + 1, to1 - (from1 + 1),
-					to1 - (from1 + 1));
-			}
-			outputOperation(DiffOperation::Inserted, from0, from1, 0, 1);
-		} else {
-			if (from0 + 1 < to0) {
-				outputOperation(DiffOperation::NotChanged, from0 + 1, from1, to0 - (from0 + 1),
-					to0 - (from0 + 1));
-			}
-			outputOperation(DiffOperation::Deleted, from0, from1, 1, 0);
-		}
-
-		to0 = from0;
-		to1 = from1;
-	}
-	if (to0 != 0)
-		outputOperation(DiffOperation::NotChanged, 0, 0, to0, to0);
-}
-
-
-void
-NPDiff::outputOperation(DiffOperation::Operator op, int from0, int from1, int count0, int count1)
-{
-	int diffResultSize = diffResult.size();
-	if (0 < diffResultSize) {
-		bool toBind = false;
-		DiffOperation& lastOperation = diffResult[diffResultSize - 1];
-		if (lastOperation.from0 == from0 + count0 && lastOperation.from1 == from1 + count1) {
-			if (DiffOperation::Inserted == op) {
-				if (DiffOperation::Inserted == lastOperation.op
-					|| DiffOperation::Modified == lastOperation.op) {
-					toBind = true;
-				} else if (DiffOperation::Deleted == lastOperation.op) {
-					lastOperation.op = DiffOperation::Modified;
-					toBind = true;
-				}
-			} else if (DiffOperation::Deleted == op) {
-				if (DiffOperation::Deleted == lastOperation.op
-					|| DiffOperation::Modified == lastOperation.op) {
-					toBind = true;
-				} else if (DiffOperation::Inserted == lastOperation.op) {
-					lastOperation.op = DiffOperation::Modified;
-					toBind = true;
-				}
-			}
-		}
-		if (toBind) {
-			lastOperation.from0 = from0;
-			lastOperation.from1 = from1;
-			lastOperation.count0 += count0;
-			lastOperation.count1 += count1;
-			return;
-		}
-	}
-
-	DiffOperation operation;
-	operation.op = op;
-	operation.from0 = from0;
-	operation.from1 = from1;
-	operation.count0 = count0;
-	operation.count1 = count1;
-	diffResult.push_back(operation);
-}
-
-
-const DiffOperation*
-NPDiff::GetOperationAt(int index)
-{
-	int resultIndex = diffResult.size() - 1 - index;
-	if (resultIndex < 0 || index < 0)
-		return NULL;
-
-	return &diffResult[resultIndex];
-}
-
-
-int
-NPDiff::getLength(int seqNo) const
-{
-	if (isSwapped)
-		seqNo = (seqNo == 0) ? 1 : 0;
-	return sequences->GetLength(seqNo);
-}
-
-
-bool
-NPDiff::isEqual(int index0, int index1) const
-{
-	if (isSwapped)
-		return sequences->IsEqual(index1, index0);
-	else
-		return sequences->IsEqual(index0, index1);
+	diffResult.Append(op, from0, from1, count0, count1);
 }
@@ -9,75 +9,41 @@
 #ifndef NPDIFF_H__INCLUDED
 #define NPDIFF_H__INCLUDED
 
-#include <vector>
+#include "DiffEngine.h"
+#include "DiffScript.h"
+#include "NPDiffCore.h"
 
 
-class Sequences {
-public:
-						Sequences() {}
-	virtual				~Sequences() {}
-
-	virtual	int			GetLength(int seqNo) const = 0;
-	virtual bool		IsEqual(int index0, int index1) const = 0;
-};
-
-
-struct DiffOperation {
-	enum Operator {
-		Inserted = 0,
-		Modified,
-		Deleted,
-		NotChanged,
-	};
-
-	Operator	op;
-	int			from0;
-	int			from1;
-	int			count0;
-	int			count1;
-};
-
 /*
  *	S Wu, U Manber, G Myers, W Miller:
  *  "An O(NP) Sequence Comparison Algorithm",
  *	Information Processing Letters (1990)
+ *
+ *	The O(NP) search keeps its whole trace, which takes O((M+N)P) memory.
+ *	When the trace would grow beyond the memory budget, the linear space
+ *	divide-and-conquer variant of Myers' O(ND) algorithm is used instead.
+ *
+ *	The searches themselves live in NPDiffCore; this class picks the
+ *	instantiation that fits the given Sequences.
  */
-class NPDiff {
+class NPDiff : public DiffEngine, private NPDiffOutput {
 public:
 						NPDiff();
 	virtual				~NPDiff();
 
-			void			Detect(const Sequences* sequences);
-	const DiffOperation*	GetOperationAt(int index);
+	virtual	void			Detect(const Sequences* sequences);
+	virtual	const DiffOperation*	GetOperationAt(int index) const
+								{ return diffResult.GetOperationAt(index); }
 
 private:
-			void		snake(int k);
-			void		makeResult();
-			void		outputOperation(DiffOperation::Operator op,
-							int from0, int from1, int count0, int count1);
+	template<class Elements>
+			void		detect(const Elements& elements, int length0, int length1);
 
-			int			getLength(int seqNo) const;
-			bool		isEqual(int index0, int index1) const;
+	virtual	void		OutputOperation(DiffOperation::Operator op,
+							int from0, int from1, int count0, int count1);
 
 private:
-	// furthest point
-	struct FPData {
-		int		y;					//< furthest point
-		int		x;					//< furthest point
-		int		prevFPDataIndex;	//< FPData （NPDiff::fpDataVector）
-	};
-
-	typedef std::vector<FPData>	FPDataVector;
-	typedef std::vector<DiffOperation> DiffOpVector;
-
-	const Sequences*	sequences;
-	bool				isSwapped;		//< m <= n, true
-	DiffOpVector		diffResult;
-
-	// Detect()
-	FPDataVector		fpDataVector;
-	int*				fp;
-	int*				fpBuffer;
+	DiffScript			diffResult;
 };
 
 #endif // NPDIFF_H__INCLUDED
@@ -0,0 +1,714 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef NPDIFFCORE_H
+#define NPDIFFCORE_H
+
+#include <algorithm>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "DiffEngine.h"
+#include "Exception.h"
+#include "SimdKernels.h"
+
+
+/*
+ *	Element access for NPDiffCore. An Elements type provides an inline
+ *	IsEqual(index0, index1), and CountEqual() and CountEqualBackward() which
+ *	measure a run of equal elements starting at, or ending before, the given
+ *	indices. CountCommon() bounds the number of elements any script of two
+ *	windows can keep. The core never calls through Sequences.
+ */
+class IDElements {
+public:
+						IDElements(const uint32_t* ids0, const uint32_t* ids1)
+							{ fIDs0 = ids0; fIDs1 = ids1; }
+
+			bool		IsEqual(int index0, int index1) const
+							{ return fIDs0[index0] == fIDs1[index1]; }
+
+			int			CountEqual(int index0, int index1, int count) const
+							{
+								if (count <= 0)
+									return 0;
+								return CountEqualPrefix(fIDs0 + index0, fIDs1 + index1,
+									count);
+							}
+			int			CountEqualBackward(int end0, int end1, int count) const
+							{
+								if (count <= 0)
+									return 0;
+								return CountEqualSuffix(fIDs0 + end0 - count,
+									fIDs1 + end1 - count, count);
+							}
+
+			int			CountCommon(int begin0, int end0, int begin1,
+							int end1) const;
+
+private:
+	const	uint32_t*	fIDs0;
+	const	uint32_t*	fIDs1;
+};
+
+
+/*
+ *	Counts the IDs both windows have, as often as both have them: no script
+ *	keeps more elements. Returns the shorter length, which bounds nothing,
+ *	if the counters do not fit into memory.
+ */
+inline int
+IDElements::CountCommon(int begin0, int end0, int begin1, int end1) const
+{
+	int length0 = end0 - begin0;
+	int length1 = end1 - begin1;
+	int minLength = (length0 < length1) ? length0 : length1;
+
+	// interned IDs are dense, so a counter per ID up to the largest will do
+	uint32_t maxID = 0;
+	int index;
+	for (index = begin0; index < end0; index++)
+		maxID = std::max(maxID, fIDs0[index]);
+	for (index = begin1; index < end1; index++)
+		maxID = std::max(maxID, fIDs1[index]);
+
+	std::vector<int> counts;
+	try {
+		counts.assign(static_cast<size_t>(maxID) + 1, 0);
+	} catch (std::bad_alloc&) {
+		return minLength;
+	}
+
+	for (index = begin0; index < end0; index++)
+		counts[fIDs0[index]]++;
+
+	int common = 0;
+	for (index = begin1; index < end1; index++) {
+		int& count = counts[fIDs1[index]];
+		if (count > 0) {
+			count--;
+			common++;
+		}
+	}
+	return common;
+}
+
+
+/*
+ *	Adapter for sequences without element IDs: one virtual call per compare.
+ */
+class SequencesElements {
+public:
+						SequencesElements(const Sequences* sequences)
+							{ fSequences = sequences; }
+
+			bool		IsEqual(int index0, int index1) const
+							{ return fSequences->IsEqual(index0, index1); }
+
+			int			CountEqual(int index0, int index1, int count) const
+							{
+								int run = 0;
+								while (run < count && IsEqual(index0 + run, index1 + run))
+									run++;
+								return run;
+							}
+			int			CountEqualBackward(int end0, int end1, int count) const
+							{
+								int run = 0;
+								while (run < count && IsEqual(end0 - 1 - run, end1 - 1 - run))
+									run++;
+								return run;
+							}
+
+			// without IDs, only the lengths are known
+			int			CountCommon(int begin0, int end0, int begin1,
+							int end1) const
+							{ return std::min(end0 - begin0, end1 - begin1); }
+
+private:
+	const	Sequences*	fSequences;
+};
+
+
+/*
+ *	Receives the operations found by NPDiffCore, in order.
+ */
+class NPDiffOutput {
+public:
+	virtual				~NPDiffOutput() {}
+
+	virtual	void		OutputOperation(DiffOperation::Operator op, int from0, int from1,
+							int count0, int count1) = 0;
+};
+
+
+/*
+ *	Counts the equal elements at the head and at the tail of a window.
+ */
+template<class Elements>
+inline void
+TrimCommonEnds(const Elements& elements, int begin0, int end0, int begin1, int end1,
+	int& head, int& tail)
+{
+	int length0 = end0 - begin0;
+	int length1 = end1 - begin1;
+	int minLength = (length0 < length1) ? length0 : length1;
+
+	head = elements.CountEqual(begin0, begin1, minLength);
+	tail = elements.CountEqualBackward(end0, end1, minLength - head);
+}
+
+
+/*
+ *	The searches behind NPDiff, compiled for one element type and one swap
+ *	direction. The O(NP) search walks the shorter window along x; kSwapped
+ *	tells at compile time whether that is sequence 1, so a snake is a single
+ *	CountEqual() call against bounds computed once.
+ *
+ *	Like GNU diff, the searches give up on minimality once they become too
+ *	expensive: past the cost limit the middle snake search splits at the
+ *	furthest point reached so far, and past the deadline the remaining
+ *	windows are output as a whole, as deleted and inserted elements.
+ *	Cancelling the progress counts as running out of time.
+ */
+template<class Elements, bool kSwapped>
+class NPDiffCore {
+public:
+						NPDiffCore(const Elements& elements, NPDiffOutput* output,
+							size_t memoryBudget, int costLimit = 0,
+							int64_t deadline = 0, DiffProgress* progress = NULL);
+						~NPDiffCore();
+
+			// kSwapped must be (length0 > length1)
+			void		Detect(int begin0, int begin1, int length0, int length1);
+
+			bool		IsApproximate() const { return fIsApproximate; }
+
+private:
+	// furthest point
+	struct FPData {
+		int		y;					//< furthest point
+		int		x;					//< furthest point
+		int		prevFPDataIndex;	//< index into fFPDataVector
+	};
+	typedef std::vector<FPData>	FPDataVector;
+	typedef std::vector<int>	IndexVector;
+
+			int			_CountEqual(int x, int y, int count) const;
+			void		_Output(DiffOperation::Operator op, int from0, int from1,
+							int count0, int count1)
+							{ fOutput->OutputOperation(op, from0, from1, count0, count1); }
+
+			bool		_IsTooExpensive(int rounds);
+
+			bool		_DetectTrace();
+	static	uint64_t	_TraceSize(int p, int delta);
+			void		_Snake(int k);
+			void		_MakeResult(int fpDataIndex);
+			void		_MakePartialResult(int p);
+
+			void		_DetectLinear();
+			void		_Divide(int begin0, int end0, int begin1, int end1);
+			void		_FindMiddleSnake(int begin0, int end0, int begin1, int end1,
+							int& snakeBegin0, int& snakeBegin1, int& snakeEnd0,
+							int& snakeEnd1);
+
+private:
+			Elements	fElements;
+			NPDiffOutput*	fOutput;
+			size_t		fMemoryBudget;
+			int			fCostLimit;		//< 0 for no limit
+			int64_t		fDeadline;		//< 0 for no limit
+			DiffProgress*	fProgress;	//< NULL if not reported
+			bool		fIsOutOfTime;
+			bool		fIsApproximate;
+
+			int			fBegin0;
+			int			fBegin1;
+			int			fM;				//< length along x, the shorter one
+			int			fN;				//< length along y
+
+			// _DetectTrace()
+			FPDataVector	fFPDataVector;
+			IndexVector	fPath;			//< for _MakeResult()
+			int*		fFP;
+			int*		fFPBuffer;
+
+			// _DetectLinear()
+			int*		fLinearBuffer;
+			int*		fForwardX;
+			int*		fBackwardX;
+};
+
+
+template<class Elements, bool kSwapped>
+NPDiffCore<Elements, kSwapped>::NPDiffCore(const Elements& elements, NPDiffOutput* output,
+	size_t memoryBudget, int costLimit, int64_t deadline, DiffProgress* progress)
+	:
+	fElements(elements)
+{
+	fOutput = output;
+	fMemoryBudget = memoryBudget;
+	fCostLimit = costLimit;
+	fDeadline = deadline;
+	fProgress = progress;
+	fIsOutOfTime = false;
+	fIsApproximate = false;
+	fBegin0 = fBegin1 = 0;
+	fM = fN = 0;
+	fFP = fFPBuffer = NULL;
+	fLinearBuffer = fForwardX = fBackwardX = NULL;
+}
+
+
+template<class Elements, bool kSwapped>
+NPDiffCore<Elements, kSwapped>::~NPDiffCore()
+{
+	free(fFPBuffer);
+	free(fLinearBuffer);
+}
+
+
+template<class Elements, bool kSwapped>
+void
+NPDiffCore<Elements, kSwapped>::Detect(int begin0, int begin1, int length0, int length1)
+{
+	if (length0 == 0 || length1 == 0) {
+		if (length0 > 0)
+			_Output(DiffOperation::Deleted, begin0, begin1, length0, 0);
+		else if (length1 > 0)
+			_Output(DiffOperation::Inserted, begin0, begin1, 0, length1);
+		return;
+	}
+
+	fBegin0 = begin0;
+	fBegin1 = begin1;
+	fM = (kSwapped) ? length1 : length0;
+	fN = (kSwapped) ? length0 : length1;
+
+	if (!_DetectTrace())
+		_DetectLinear();
+}
+
+
+template<class Elements, bool kSwapped>
+inline int
+NPDiffCore<Elements, kSwapped>::_CountEqual(int x, int y, int count) const
+{
+	if (kSwapped)
+		return fElements.CountEqual(fBegin0 + y, fBegin1 + x, count);
+	return fElements.CountEqual(fBegin0 + x, fBegin1 + y, count);
+}
+
+
+template<class Elements, bool kSwapped>
+bool
+NPDiffCore<Elements, kSwapped>::_IsTooExpensive(int rounds)
+{
+	if (fProgress != NULL) {
+		fProgress->AddRounds(1);
+		if (fProgress->IsCanceled())
+			fIsOutOfTime = true;
+	}
+	if (fCostLimit > 0 && rounds >= fCostLimit)
+		return true;
+	if (fDeadline > 0 && !fIsOutOfTime && DiffEngine::CurrentTime() >= fDeadline)
+		fIsOutOfTime = true;
+	return fIsOutOfTime;
+}
+
+
+/*
+ *	Returns false, without output, when the trace would outgrow the memory
+ *	budget or the cost limit. When it runs out of time, the trace found so
+ *	far is used as far as it goes.
+ */
+template<class Elements, bool kSwapped>
+bool
+NPDiffCore<Elements, kSwapped>::_DetectTrace()
+{
+	int m = fM;
+	int n = fN;
+	int delta = n - m;
+
+	// The trace grows by delta + 2p + 1 records in round p. Once the next
+	// round is predicted to exceed the memory budget, give up on the trace.
+	size_t traceLimit = fMemoryBudget / sizeof(FPData);
+	if (static_cast<size_t>(delta) + 1 > traceLimit)
+		return false;
+
+	// Rounds 0 to P take (P + 1)(delta + P + 1) records, and P, the number
+	// of elements deleted from the shorter window, is at least the number
+	// it has without a partner. Where even that would not fit, go to linear
+	// space right away, rather than after searching the rounds that fit.
+	if (_TraceSize(m, delta) > traceLimit) {
+		int end0 = fBegin0 + ((kSwapped) ? n : m);
+		int end1 = fBegin1 + ((kSwapped) ? m : n);
+		int leastP = m - fElements.CountCommon(fBegin0, end0, fBegin1, end1);
+		if (_TraceSize(leastP, delta) > traceLimit)
+			return false;
+	}
+
+	fFPBuffer = static_cast<int*>(malloc((m + n + 3) * sizeof(int)));
+	if (fFPBuffer == NULL)
+		MemoryException::Throw();
+
+	memset(fFPBuffer, 0, (m + n + 3) * sizeof(int));
+	fFP = fFPBuffer + m + 1;
+
+	// P never exceeds m; it reaches m when no element is common at all.
+	bool overBudget = false;
+	int p;
+	for (p = 0; p <= m; p++) {
+		if (fFPDataVector.size() + delta + 2 * static_cast<size_t>(p) + 1 > traceLimit
+			|| (p > 0 && _IsTooExpensive(p))) {
+			overBudget = true;
+			break;
+		}
+
+		int k;
+		for (k = -p; k <= delta - 1; k++)
+			_Snake(k);
+		for (k = delta + p; k >= delta; k--)
+			_Snake(k);
+
+		int fpDataIndexDelta = fFP[delta] - 1;
+		int fpDelta = (0 > fpDataIndexDelta) ? -1 : fFPDataVector[fpDataIndexDelta].y;
+		if (fpDelta == n)
+			break;
+	}
+
+	if (!overBudget)
+		_MakeResult(fFPDataVector.size() - 1);
+	else if (fIsOutOfTime) {
+		_MakePartialResult(p - 1);
+		overBudget = false;
+	}
+
+	free(fFPBuffer);
+	fFPBuffer = fFP = NULL;
+	FPDataVector().swap(fFPDataVector);
+
+	return !overBudget;
+}
+
+
+/*
+ *	Returns the number of records of the trace after round p.
+ */
+template<class Elements, bool kSwapped>
+/*static*/ inline uint64_t
+NPDiffCore<Elements, kSwapped>::_TraceSize(int p, int delta)
+{
+	return static_cast<uint64_t>(p + 1) * (static_cast<uint64_t>(delta) + p + 1);
+}
+
+
+template<class Elements, bool kSwapped>
+inline void
+NPDiffCore<Elements, kSwapped>::_Snake(int k)
+{
+	int fpDataIndex0 = fFP[k - 1] - 1;
+	int fpDataIndex1 = fFP[k + 1] - 1;
+
+	int fpY0 = (0 > fpDataIndex0) ? -1 : fFPDataVector[fpDataIndex0].y;
+	int fpY1 = (0 > fpDataIndex1) ? -1 : fFPDataVector[fpDataIndex1].y;
+
+	FPData data;
+	if (fpY0 + 1 > fpY1) {
+		data.y = fpY0 + 1;
+		data.prevFPDataIndex = fpDataIndex0;
+	} else {
+		data.y = fpY1;
+		data.prevFPDataIndex = fpDataIndex1;
+	}
+
+	data.x = data.y - k;
+	int limit0 = fM - data.x;
+	int limit1 = fN - data.y;
+	int run = _CountEqual(data.x, data.y, (limit0 < limit1) ? limit0 : limit1);
+	data.x += run;
+	data.y += run;
+
+	fFPDataVector.push_back(data);
+	fFP[k] = static_cast<int>(fFPDataVector.size());
+}
+
+
+/*
+ *	Outputs the path that leads to the furthest point of round p, and the
+ *	rest of the window as deleted and inserted elements.
+ */
+template<class Elements, bool kSwapped>
+void
+NPDiffCore<Elements, kSwapped>::_MakePartialResult(int p)
+{
+	int delta = fN - fM;
+	int bestIndex = -1;
+	int bestProgress = -1;
+	int k;
+	for (k = -p; k <= delta + p; k++) {
+		int fpDataIndex = fFP[k] - 1;
+		if (fpDataIndex < 0)
+			continue;
+		const FPData& data = fFPDataVector[fpDataIndex];
+		if (data.x + data.y > bestProgress) {
+			bestIndex = fpDataIndex;
+			bestProgress = data.x + data.y;
+		}
+	}
+
+	const FPData& best = fFPDataVector[bestIndex];
+	int from0 = fBegin0 + ((kSwapped) ? best.y : best.x);
+	int from1 = fBegin1 + ((kSwapped) ? best.x : best.y);
+	int end0 = fBegin0 + ((kSwapped) ? fN : fM);
+	int end1 = fBegin1 + ((kSwapped) ? fM : fN);
+
+	_MakeResult(bestIndex);
+	if (from0 < end0)
+		_Output(DiffOperation::Deleted, from0, from1, end0 - from0, 0);
+	if (from1 < end1)
+		_Output(DiffOperation::Inserted, end0, from1, 0, end1 - from1);
+	fIsApproximate = true;
+}
+
+
+/*
+ *	Outputs the path that ends at the given furthest point. The trace links
+ *	each point to its predecessor, so the path is collected backwards first.
+ */
+template<class Elements, bool kSwapped>
+void
+NPDiffCore<Elements, kSwapped>::_MakeResult(int fpDataIndex)
+{
+	int base0 = fBegin0;
+	int base1 = fBegin1;
+
+	fPath.clear();
+	for (; 0 <= fpDataIndex; fpDataIndex = fFPDataVector[fpDataIndex].prevFPDataIndex)
+		fPath.push_back(fpDataIndex);
+
+	// the first snake starts at the beginning of the window
+	int index = fPath.size() - 1;
+	const FPData* data = &fFPDataVector[fPath[index]];
+	int from0 = base0 + ((kSwapped) ? data->y : data->x);
+	int from1 = base1 + ((kSwapped) ? data->x : data->y);
+	if (from0 != base0)
+		_Output(DiffOperation::NotChanged, base0, base1, from0 - base0, from0 - base0);
+
+	for (index--; index >= 0; index--) {
+		data = &fFPDataVector[fPath[index]];
+		int to0 = base0 + ((kSwapped) ? data->y : data->x);
+		int to1 = base1 + ((kSwapped) ? data->x : data->y);
+		if (from1 - from0 < to1 - to0) {
+			_Output(DiffOperation::Inserted, from0, from1, 0, 1);
+			if (from1 + 1 < to1) {
+				_Output(DiffOperation::NotChanged, from0, from1 + 1, to1 - (from1 + 1),
+					to1 - (from1 + 1));
+			}
+		} else {
+			_Output(DiffOperation::Deleted, from0, from1, 1, 0);
+			if (from0 + 1 < to0) {
+				_Output(DiffOperation::NotChanged, from0 + 1, from1, to0 - (from0 + 1),
+					to0 - (from0 + 1));
+			}
+		}
+
+		from0 = to0;
+		from1 = to1;
+	}
+
+	IndexVector().swap(fPath);
+}
+
+
+template<class Elements, bool kSwapped>
+void
+NPDiffCore<Elements, kSwapped>::_DetectLinear()
+{
+	int length0 = (kSwapped) ? fN : fM;
+	int length1 = (kSwapped) ? fM : fN;
+
+	// forward and backward furthest points, indexed by diagonal; the
+	// backward diagonals are shifted by delta, so allow for twice the range
+	int diagonals = 2 * (length0 + length1) + 3;
+	fLinearBuffer = static_cast<int*>(malloc(2 * (2 * diagonals + 1) * sizeof(int)));
+	if (fLinearBuffer == NULL)
+		MemoryException::Throw();
+	fForwardX = fLinearBuffer + diagonals;
+	fBackwardX = fLinearBuffer + (2 * diagonals + 1) + diagonals;
+
+	_Divide(fBegin0, fBegin0 + length0, fBegin1, fBegin1 + length1);
+
+	free(fLinearBuffer);
+	fLinearBuffer = fForwardX = fBackwardX = NULL;
+}
+
+
+template<class Elements, bool kSwapped>
+void
+NPDiffCore<Elements, kSwapped>::_Divide(int begin0, int end0, int begin1, int end1)
+{
+	int head, tail;
+	TrimCommonEnds(fElements, begin0, end0, begin1, end1, head, tail);
+
+	if (head > 0)
+		_Output(DiffOperation::NotChanged, begin0, begin1, head, head);
+	begin0 += head;
+	begin1 += head;
+	end0 -= tail;
+	end1 -= tail;
+
+	if (begin0 == end0) {
+		if (begin1 < end1)
+			_Output(DiffOperation::Inserted, begin0, begin1, 0, end1 - begin1);
+	} else if (begin1 == end1) {
+		_Output(DiffOperation::Deleted, begin0, begin1, end0 - begin0, 0);
+	} else if (fIsOutOfTime) {
+		_Output(DiffOperation::Deleted, begin0, begin1, end0 - begin0, 0);
+		_Output(DiffOperation::Inserted, end0, begin1, 0, end1 - begin1);
+		fIsApproximate = true;
+	} else {
+		// Both parts are not empty and differ at both ends, so the edit
+		// distance is at least 2 and both halves are strictly smaller.
+		int snakeBegin0, snakeBegin1, snakeEnd0, snakeEnd1;
+		_FindMiddleSnake(begin0, end0, begin1, end1, snakeBegin0, snakeBegin1, snakeEnd0,
+			snakeEnd1);
+
+		_Divide(begin0, snakeBegin0, begin1, snakeBegin1);
+		if (snakeBegin0 < snakeEnd0) {
+			_Output(DiffOperation::NotChanged, snakeBegin0, snakeBegin1,
+				snakeEnd0 - snakeBegin0, snakeEnd0 - snakeBegin0);
+		}
+		_Divide(snakeEnd0, end0, snakeEnd1, end1);
+	}
+
+	if (tail > 0)
+		_Output(DiffOperation::NotChanged, end0, end1, tail, tail);
+}
+
+
+/*
+ *	E W Myers:
+ *	"An O(ND) Difference Algorithm and Its Variations",
+ *	Algorithmica (1986), section 4b
+ *
+ *	Works on absolute, unswapped coordinates.
+ */
+template<class Elements, bool kSwapped>
+void
+NPDiffCore<Elements, kSwapped>::_FindMiddleSnake(int begin0, int end0, int begin1, int end1,
+	int& snakeBegin0, int& snakeBegin1, int& snakeEnd0, int& snakeEnd1)
+{
+	const Elements& elements = fElements;
+	int* forwardX = fForwardX;
+	int* backwardX = fBackwardX;
+
+	int n = end0 - begin0;
+	int m = end1 - begin1;
+	int delta = n - m;
+	bool isOdd = (delta & 1) != 0;
+	int maxD = (n + m + 1) / 2;
+
+	// diagonal k is x - y, with x and y relative to begin0 and begin1
+	forwardX[1] = 0;
+	backwardX[delta - 1] = n;
+
+	int d;
+	for (d = 0; d <= maxD; d++) {
+		int k;
+		for (k = -d; k <= d; k += 2) {
+			int x;
+			if (k == -d || (k != d && forwardX[k - 1] < forwardX[k + 1]))
+				x = forwardX[k + 1];
+			else
+				x = forwardX[k - 1] + 1;
+			int y = x - k;
+			int startX = x;
+			int startY = y;
+			int run = elements.CountEqual(begin0 + x, begin1 + y,
+				(n - x < m - y) ? n - x : m - y);
+			x += run;
+			y += run;
+			forwardX[k] = x;
+
+			if (isOdd && k >= delta - (d - 1) && k <= delta + (d - 1) && backwardX[k] <= x) {
+				snakeBegin0 = begin0 + startX;
+				snakeBegin1 = begin1 + startY;
+				snakeEnd0 = begin0 + x;
+				snakeEnd1 = begin1 + y;
+				return;
+			}
+		}
+
+		for (k = -d; k <= d; k += 2) {
+			int diagonal = k + delta;
+			int x;
+			if (k == d || (k != -d && backwardX[diagonal - 1] < backwardX[diagonal + 1]))
+				x = backwardX[diagonal - 1];
+			else
+				x = backwardX[diagonal + 1] - 1;
+			int y = x - diagonal;
+			int endX = x;
+			int endY = y;
+			int run = elements.CountEqualBackward(begin0 + x, begin1 + y,
+				(x < y) ? x : y);
+			x -= run;
+			y -= run;
+			backwardX[diagonal] = x;
+
+			if (!isOdd && diagonal >= -d && diagonal <= d && x <= forwardX[diagonal]) {
+				snakeBegin0 = begin0 + x;
+				snakeBegin1 = begin1 + y;
+				snakeEnd0 = begin0 + endX;
+				snakeEnd1 = begin1 + endY;
+				return;
+			}
+		}
+
+		if (!_IsTooExpensive(d + 1))
+			continue;
+
+		// Too expensive: split at the point that got furthest, measured
+		// from its own corner, on either side.
+		int bestX = -1;
+		int bestY = -1;
+		int bestProgress = 0;
+		for (k = -d; k <= d; k += 2) {
+			int x = forwardX[k];
+			int y = x - k;
+			if (x <= n && y >= 0 && y <= m && x + y > bestProgress
+				&& (x < n || y < m)) {
+				bestX = x;
+				bestY = y;
+				bestProgress = x + y;
+			}
+
+			x = backwardX[k + delta];
+			y = x - (k + delta);
+			if (x >= 0 && y >= 0 && y <= m && n + m - (x + y) > bestProgress
+				&& (x > 0 || y > 0)) {
+				bestX = x;
+				bestY = y;
+				bestProgress = n + m - (x + y);
+			}
+		}
+		if (bestX < 0)
+			continue;
+
+		snakeBegin0 = snakeEnd0 = begin0 + bestX;
+		snakeBegin1 = snakeEnd1 = begin1 + bestY;
+		fIsApproximate = true;
+		return;
+	}
+
+	// not reached for valid sequences
+	snakeBegin0 = snakeEnd0 = begin0;
+	snakeBegin1 = snakeEnd1 = begin1;
+}
+
+#endif // NPDIFFCORE_H
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "ParallelDiff.h"
+#include "Exception.h"
+#include "PatienceDiff.h"
+#include "ThreadPool.h"
+
+
+const int ParallelDiff::kMinParallelLength = 100000;
+
+// elements of both sides per segment; small enough to give several
+// segments per thread on the inputs worth splitting
+const int ParallelDiff::kSegmentLength = 25000;
+
+
+class ParallelDiff::SegmentTask : public PoolTask {
+public:
+	SegmentTask(const Sequences* sequences, const Segment& segment)
+		:
+		fSegment(segment),
+		fSequences(sequences, segment.begin0, segment.end0 - segment.begin0,
+			segment.begin1, segment.end1 - segment.begin1),
+		fException(NULL)
+	{
+	}
+
+	virtual void Run()
+	{
+		try {
+			fDiff.Detect(&fSequences);
+		} catch (Exception* ex) {
+			fException = ex;
+		}
+	}
+
+	Segment			fSegment;
+	SubSequences	fSequences;
+	NPDiff			fDiff;
+	Exception*		fException;
+};
+
+
+ParallelDiff::ParallelDiff(ThreadPool* pool)
+{
+	fPool = pool;
+	fOwnsPool = false;
+}
+
+
+ParallelDiff::~ParallelDiff()
+{
+	if (fOwnsPool)
+		delete fPool;
+}
+
+
+void
+ParallelDiff::Detect(const Sequences* sequences)
+{
+	fScript.Clear();
+	fScript.SetSink(GetSink());
+	_StartClock();
+	if (sequences == NULL)
+		return;
+
+	int length0 = sequences->GetLength(0);
+	int length1 = sequences->GetLength(1);
+	if (sequences->GetIDs(0) == NULL || sequences->GetIDs(1) == NULL
+		|| length0 + length1 < kMinParallelLength) {
+		_DetectSequentially(sequences);
+		return;
+	}
+
+	if (fPool == NULL) {
+		fPool = new ThreadPool();
+		fOwnsPool = true;
+	}
+
+	AnchorVector anchors;
+	_FindAnchors(sequences, anchors);
+
+	SegmentVector segments;
+	_MakeSegments(sequences, anchors, segments);
+	if (segments.size() < 2) {
+		_DetectSequentially(sequences);
+		return;
+	}
+
+	std::vector<SegmentTask*> tasks;
+	TaskGroup group;
+	size_t index;
+	for (index = 0; index < segments.size(); index++) {
+		SegmentTask* task = new SegmentTask(sequences, segments[index]);
+		_PassLimits(task->fDiff);
+		tasks.push_back(task);
+		fPool->Submit(task, &group);
+	}
+	fPool->Wait(&group);
+
+	// stitch the segment results together in order
+	Exception* exception = NULL;
+	for (index = 0; index < tasks.size(); index++) {
+		SegmentTask* task = tasks[index];
+		if (task->fException != NULL) {
+			if (exception == NULL)
+				exception = task->fException;
+			else
+				task->fException->Delete();
+		}
+
+		if (exception == NULL) {
+			if (task->fDiff.IsApproximate())
+				_SetApproximate();
+
+			const DiffOperation* operation;
+			int opIndex;
+			for (opIndex = 0; (operation = task->fDiff.GetOperationAt(opIndex)) != NULL;
+				opIndex++) {
+				fScript.Append(operation->op, task->fSegment.begin0 + operation->from0,
+					task->fSegment.begin1 + operation->from1, operation->count0,
+					operation->count1);
+			}
+		}
+		delete task;
+	}
+
+	if (exception != NULL) {
+		fScript.Clear();
+		throw exception;
+	}
+	fScript.Flush();
+}
+
+
+void
+ParallelDiff::_DetectSequentially(const Sequences* sequences)
+{
+	// the operations go straight into the script
+	NPDiff diff;
+	_PassLimits(diff);
+	diff.SetSink(&fScript);
+	diff.Detect(sequences);
+	if (diff.IsApproximate())
+		_SetApproximate();
+
+	fScript.Flush();
+}
+
+
+void
+ParallelDiff::_FindAnchors(const Sequences* sequences, AnchorVector& anchors)
+{
+	const uint32_t* ids0 = sequences->GetIDs(0);
+	const uint32_t* ids1 = sequences->GetIDs(1);
+	int length0 = sequences->GetLength(0);
+	int length1 = sequences->GetLength(1);
+	uint32_t idLimit = sequences->GetIDLimit();
+
+	// occurrences per side, saturating at 2
+	std::vector<uint8_t> counts0(idLimit, 0);
+	std::vector<uint8_t> counts1(idLimit, 0);
+	std::vector<int> position1(idLimit, -1);
+	int index;
+	for (index = 0; index < length0; index++) {
+		if (counts0[ids0[index]] < 2)
+			counts0[ids0[index]]++;
+	}
+	for (index = 0; index < length1; index++) {
+		if (counts1[ids1[index]] < 2)
+			counts1[ids1[index]]++;
+		position1[ids1[index]] = index;
+	}
+
+	AnchorVector candidates;
+	for (index = 0; index < length0; index++) {
+		uint32_t id = ids0[index];
+		if (counts0[id] == 1 && counts1[id] == 1) {
+			Anchor anchor;
+			anchor.from0 = index;
+			anchor.from1 = position1[id];
+			anchor.count = 1;
+			candidates.push_back(anchor);
+		}
+	}
+
+	// keep the longest run of candidates in the same order on both sides
+	PatienceDiff::SelectIncreasing(candidates);
+	anchors.swap(candidates);
+}
+
+
+void
+ParallelDiff::_MakeSegments(const Sequences* sequences, const AnchorVector& anchors,
+	SegmentVector& segments)
+{
+	int length0 = sequences->GetLength(0);
+	int length1 = sequences->GetLength(1);
+
+	// every segment ends right after an anchor, so the anchor stays
+	// unchanged at the tail of the segment
+	Segment segment;
+	segment.begin0 = 0;
+	segment.begin1 = 0;
+	size_t index;
+	for (index = 0; index < anchors.size(); index++) {
+		const Anchor& anchor = anchors[index];
+		int size = (anchor.from0 + 1 - segment.begin0) + (anchor.from1 + 1 - segment.begin1);
+		if (size < kSegmentLength)
+			continue;
+
+		segment.end0 = anchor.from0 + 1;
+		segment.end1 = anchor.from1 + 1;
+		segments.push_back(segment);
+		segment.begin0 = segment.end0;
+		segment.begin1 = segment.end1;
+	}
+
+	segment.end0 = length0;
+	segment.end1 = length1;
+	if (segment.begin0 < segment.end0 || segment.begin1 < segment.end1 || segments.empty())
+		segments.push_back(segment);
+}
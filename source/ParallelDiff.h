@@ -0,0 +1,66 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef PARALLELDIFF_H
+#define PARALLELDIFF_H
+
+#include <vector>
+
+#include "AnchoredDiff.h"
+#include "DiffScript.h"
+#include "NPDiff.h"
+
+class ThreadPool;
+
+
+/*
+ *	Cuts the sequences at elements that occur exactly once on each side and
+ *	in the same order on both sides, and diffs the segments in between with
+ *	NPDiff on a thread pool. Needs element IDs (Sequences::GetIDs()); without
+ *	them, or for small inputs, it runs a single NPDiff.
+ *
+ *	Like PatienceDiff, the result is not minimal: the unique elements are
+ *	kept unchanged even where moving them would take fewer operations. The
+ *	segments have a fixed size, so the result does not depend on the number
+ *	of threads.
+ */
+class ParallelDiff : public DiffEngine {
+public:
+						ParallelDiff(ThreadPool* pool = NULL);
+	virtual				~ParallelDiff();
+
+	virtual	void			Detect(const Sequences* sequences);
+	virtual	const DiffOperation*	GetOperationAt(int index) const
+								{ return fScript.GetOperationAt(index); }
+
+	static	const int		kMinParallelLength;
+	static	const int		kSegmentLength;
+
+private:
+	typedef AnchoredDiff::Match		Anchor;
+
+	struct Segment {
+		int		begin0;
+		int		end0;
+		int		begin1;
+		int		end1;
+	};
+	typedef std::vector<Anchor>		AnchorVector;
+	typedef std::vector<Segment>	SegmentVector;
+
+	class SegmentTask;
+
+			void		_DetectSequentially(const Sequences* sequences);
+			void		_FindAnchors(const Sequences* sequences, AnchorVector& anchors);
+			void		_MakeSegments(const Sequences* sequences, const AnchorVector& anchors,
+							SegmentVector& segments);
+
+private:
+			ThreadPool*	fPool;
+			bool		fOwnsPool;
+			DiffScript	fScript;
+};
+
+#endif // PARALLELDIFF_H
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "PatienceDiff.h"
+
+#include <algorithm>
+
+
+PatienceDiff::PatienceDiff()
+{
+}
+
+
+PatienceDiff::~PatienceDiff()
+{
+}
+
+
+/*static*/ void
+PatienceDiff::SelectIncreasing(MatchVector& candidates)
+{
+	// patience sorting: pileTops[i] is the candidate ending the best run of
+	// length i + 1 found so far
+	std::vector<int> pileTops;
+	std::vector<int> previous(candidates.size(), -1);
+	int candidate;
+	int candidateCount = candidates.size();
+	for (candidate = 0; candidate < candidateCount; candidate++) {
+		int low = 0;
+		int high = pileTops.size();
+		while (low < high) {
+			int middle = (low + high) / 2;
+			if (candidates[pileTops[middle]].from1 < candidates[candidate].from1)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+		if (low > 0)
+			previous[candidate] = pileTops[low - 1];
+		if (low == static_cast<int>(pileTops.size()))
+			pileTops.push_back(candidate);
+		else
+			pileTops[low] = candidate;
+	}
+
+	MatchVector selected;
+	if (!pileTops.empty()) {
+		int link;
+		for (link = pileTops.back(); link >= 0; link = previous[link])
+			selected.push_back(candidates[link]);
+		std::reverse(selected.begin(), selected.end());
+	}
+	candidates.swap(selected);
+}
+
+
+bool
+PatienceDiff::_FindMatches(const Region& region, MatchVector& matches)
+{
+	const uint32_t* ids0 = fIDs[0];
+	const uint32_t* ids1 = fIDs[1];
+
+	// occurrences inside the region, saturating at 2
+	int index;
+	for (index = region.begin0; index < region.end0; index++) {
+		if (fCounts[0][ids0[index]] < 2)
+			fCounts[0][ids0[index]]++;
+	}
+	for (index = region.begin1; index < region.end1; index++) {
+		if (fCounts[1][ids1[index]] < 2)
+			fCounts[1][ids1[index]]++;
+		fPositions[ids1[index]] = index;
+	}
+
+	for (index = region.begin0; index < region.end0; index++) {
+		uint32_t id = ids0[index];
+		if (fCounts[0][id] == 1 && fCounts[1][id] == 1) {
+			Match match;
+			match.from0 = index;
+			match.from1 = fPositions[id];
+			match.count = 1;
+			matches.push_back(match);
+		}
+	}
+
+	for (index = region.begin0; index < region.end0; index++)
+		fCounts[0][ids0[index]] = 0;
+	for (index = region.begin1; index < region.end1; index++) {
+		fCounts[1][ids1[index]] = 0;
+		fPositions[ids1[index]] = -1;
+	}
+
+	if (matches.empty())
+		return false;
+
+	SelectIncreasing(matches);
+	return true;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef PATIENCEDIFF_H
+#define PATIENCEDIFF_H
+
+#include "AnchoredDiff.h"
+
+
+/*
+ *	Patience diff: anchors on the elements that occur exactly once on each
+ *	side of a region, keeping the longest run of them that is in the same
+ *	order on both sides.
+ */
+class PatienceDiff : public AnchoredDiff {
+public:
+						PatienceDiff();
+	virtual				~PatienceDiff();
+
+	// Reduces candidates, ordered by from0, to the longest subsequence that
+	// is also ordered by from1.
+	static	void		SelectIncreasing(MatchVector& candidates);
+
+protected:
+	virtual	bool		_FindMatches(const Region& region, MatchVector& matches);
+};
+
+#endif // PATIENCEDIFF_H
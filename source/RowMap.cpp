@@ -0,0 +1,104 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "RowMap.h"
+
+#include <algorithm>
+
+
+RowMap::RowMap()
+{
+	fRowCount = 0;
+	fChangeCount = 0;
+}
+
+
+RowMap::~RowMap()
+{
+}
+
+
+void
+RowMap::Clear()
+{
+	RunVector().swap(fRuns);
+	fRowCount = 0;
+	fChangeCount = 0;
+}
+
+
+void
+RowMap::AddOperation(const DiffOperation& operation)
+{
+	int32_t rows = (operation.count0 > operation.count1)
+		? operation.count0 : operation.count1;
+	if (rows == 0)
+		return;
+
+	Run run;
+	run.firstRow = fRowCount;
+	run.operation = operation;
+	fRuns.push_back(run);
+
+	fRowCount += rows;
+	if (operation.op != DiffOperation::NotChanged)
+		fChangeCount++;
+}
+
+
+/*
+ *	Turns the map into the one of the comparison with both sides exchanged.
+ *	Every operation keeps its rows, so only the runs themselves change.
+ */
+void
+RowMap::SwapSides()
+{
+	size_t index;
+	for (index = 0; index < fRuns.size(); index++) {
+		DiffOperation& operation = fRuns[index].operation;
+		std::swap(operation.from0, operation.from1);
+		std::swap(operation.count0, operation.count1);
+		if (operation.op == DiffOperation::Inserted)
+			operation.op = DiffOperation::Deleted;
+		else if (operation.op == DiffOperation::Deleted)
+			operation.op = DiffOperation::Inserted;
+	}
+}
+
+
+bool
+RowMap::GetRowAt(int32_t index, Row& row) const
+{
+	if (index < 0 || index >= fRowCount)
+		return false;
+
+	const Run& run = fRuns[_FindRun(index)];
+	const DiffOperation& operation = run.operation;
+	int32_t offset = index - run.firstRow;
+
+	row.op = operation.op;
+	row.textIndex[0] = (offset < operation.count0) ? operation.from0 + offset : -1;
+	row.textIndex[1] = (offset < operation.count1) ? operation.from1 + offset : -1;
+	return true;
+}
+
+
+/*
+ *	Returns the index of the last run starting at or before the row.
+ */
+int32_t
+RowMap::_FindRun(int32_t row) const
+{
+	int32_t low = 0;
+	int32_t high = fRuns.size();
+	while (high - low > 1) {
+		int32_t middle = low + (high - low) / 2;
+		if (fRuns[middle].firstRow <= row)
+			low = middle;
+		else
+			high = middle;
+	}
+	return low;
+}
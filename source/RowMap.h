@@ -0,0 +1,59 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef ROWMAP_H
+#define ROWMAP_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "DiffEngine.h"
+
+
+/*
+ *	Maps the rows of a side-by-side diff to the lines of both texts. Only
+ *	one entry per operation of the edit script is stored; a row is resolved
+ *	by binary search over the runs.
+ */
+class RowMap : public DiffOperationSink {
+public:
+	struct Row {
+		int32_t					textIndex[2];	//< -1 if the side has no line
+		DiffOperation::Operator	op;
+	};
+
+						RowMap();
+	virtual				~RowMap();
+
+			void		Clear();
+	virtual	void		AddOperation(const DiffOperation& operation);
+			void		SwapSides();
+
+			int32_t		CountRows() const { return fRowCount; }
+			bool		GetRowAt(int32_t index, Row& row) const;
+
+			int32_t		CountOperations() const { return fRuns.size(); }
+	const DiffOperation&	OperationAt(int32_t index) const
+							{ return fRuns[index].operation; }
+
+			// true if no operation changes anything
+			bool		IsIdentical() const { return fChangeCount == 0; }
+
+private:
+	struct Run {
+		int32_t		firstRow;
+		DiffOperation	operation;
+	};
+	typedef std::vector<Run>	RunVector;
+
+			int32_t		_FindRun(int32_t row) const;
+
+private:
+			RunVector	fRuns;
+			int32_t		fRowCount;
+			int32_t		fChangeCount;
+};
+
+#endif // ROWMAP_H
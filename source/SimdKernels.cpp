@@ -0,0 +1,235 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "SimdKernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && __GNUC__ >= 5
+#	define SIMD_KERNELS_X86 1
+#	include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#	define SIMD_KERNELS_NEON 1
+#	include <arm_neon.h>
+#endif
+
+
+static size_t
+count_equal_prefix_scalar(const uint32_t* a, const uint32_t* b, size_t count)
+{
+	size_t index = 0;
+	while (index < count && a[index] == b[index])
+		index++;
+	return index;
+}
+
+
+static size_t
+count_equal_suffix_scalar(const uint32_t* a, const uint32_t* b, size_t count)
+{
+	size_t index = count;
+	while (index > 0 && a[index - 1] == b[index - 1])
+		index--;
+	return count - index;
+}
+
+
+static const char*
+find_line_break_scalar(const char* begin, const char* end)
+{
+	const char* ptr = begin;
+	while (ptr < end && *ptr != '\n' && *ptr != '\r')
+		ptr++;
+	return ptr;
+}
+
+
+#ifdef SIMD_KERNELS_X86
+
+__attribute__((target("sse2"))) static size_t
+count_equal_prefix_sse2(const uint32_t* a, const uint32_t* b, size_t count)
+{
+	size_t index = 0;
+	for (; index + 4 <= count; index += 4) {
+		__m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + index));
+		__m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + index));
+		unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(va, vb));
+		if (mask != 0xffff)
+			return index + (__builtin_ctz(~mask) >> 2);
+	}
+	return index + count_equal_prefix_scalar(a + index, b + index, count - index);
+}
+
+
+__attribute__((target("sse2"))) static size_t
+count_equal_suffix_sse2(const uint32_t* a, const uint32_t* b, size_t count)
+{
+	size_t end = count;
+	for (; end >= 4; end -= 4) {
+		__m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + end - 4));
+		__m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + end - 4));
+		unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(va, vb));
+		if (mask != 0xffff) {
+			// the last differing lane is the highest clear bit group
+			int lane = (31 - __builtin_clz(~mask & 0xffff)) >> 2;
+			return count - end + (3 - lane);
+		}
+	}
+	return count - end + count_equal_suffix_scalar(a, b, end);
+}
+
+
+__attribute__((target("avx2"))) static size_t
+count_equal_prefix_avx2(const uint32_t* a, const uint32_t* b, size_t count)
+{
+	size_t index = 0;
+	for (; index + 8 <= count; index += 8) {
+		__m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + index));
+		__m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + index));
+		unsigned int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi32(va, vb));
+		if (mask != 0xffffffff)
+			return index + (__builtin_ctz(~mask) >> 2);
+	}
+	return index + count_equal_prefix_sse2(a + index, b + index, count - index);
+}
+
+
+__attribute__((target("avx2"))) static size_t
+count_equal_suffix_avx2(const uint32_t* a, const uint32_t* b, size_t count)
+{
+	size_t end = count;
+	for (; end >= 8; end -= 8) {
+		__m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + end - 8));
+		__m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + end - 8));
+		unsigned int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi32(va, vb));
+		if (mask != 0xffffffff) {
+			int lane = (31 - __builtin_clz(~mask)) >> 2;
+			return count - end + (7 - lane);
+		}
+	}
+	return count - end + count_equal_suffix_sse2(a, b, end);
+}
+
+
+__attribute__((target("sse2"))) static const char*
+find_line_break_sse2(const char* begin, const char* end)
+{
+	const __m128i lf = _mm_set1_epi8('\n');
+	const __m128i cr = _mm_set1_epi8('\r');
+	const char* ptr = begin;
+	for (; end - ptr >= 16; ptr += 16) {
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+		unsigned int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, lf),
+			_mm_cmpeq_epi8(bytes, cr)));
+		if (mask != 0)
+			return ptr + __builtin_ctz(mask);
+	}
+	return find_line_break_scalar(ptr, end);
+}
+
+
+__attribute__((target("avx2"))) static const char*
+find_line_break_avx2(const char* begin, const char* end)
+{
+	const __m256i lf = _mm256_set1_epi8('\n');
+	const __m256i cr = _mm256_set1_epi8('\r');
+	const char* ptr = begin;
+	for (; end - ptr >= 32; ptr += 32) {
+		__m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+		unsigned int mask = _mm256_movemask_epi8(_mm256_or_si256(
+			_mm256_cmpeq_epi8(bytes, lf), _mm256_cmpeq_epi8(bytes, cr)));
+		if (mask != 0)
+			return ptr + __builtin_ctz(mask);
+	}
+	return find_line_break_sse2(ptr, end);
+}
+
+#endif // SIMD_KERNELS_X86
+
+
+#ifdef SIMD_KERNELS_NEON
+
+static size_t
+count_equal_prefix_neon(const uint32_t* a, const uint32_t* b, size_t count)
+{
+	size_t index = 0;
+	for (; index + 4 <= count; index += 4) {
+		uint32x4_t equal = vceqq_u32(vld1q_u32(a + index), vld1q_u32(b + index));
+		if (vminvq_u32(equal) == 0)
+			break;
+	}
+	return index + count_equal_prefix_scalar(a + index, b + index, count - index);
+}
+
+
+static size_t
+count_equal_suffix_neon(const uint32_t* a, const uint32_t* b, size_t count)
+{
+	size_t end = count;
+	for (; end >= 4; end -= 4) {
+		uint32x4_t equal = vceqq_u32(vld1q_u32(a + end - 4), vld1q_u32(b + end - 4));
+		if (vminvq_u32(equal) == 0)
+			break;
+	}
+	return count - end + count_equal_suffix_scalar(a, b, end);
+}
+
+
+static const char*
+find_line_break_neon(const char* begin, const char* end)
+{
+	const uint8x16_t lf = vdupq_n_u8('\n');
+	const uint8x16_t cr = vdupq_n_u8('\r');
+	const char* ptr = begin;
+	for (; end - ptr >= 16; ptr += 16) {
+		uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(ptr));
+		uint8x16_t found = vorrq_u8(vceqq_u8(bytes, lf), vceqq_u8(bytes, cr));
+		// narrow to four bits per byte to get a scalar mask
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(
+			vshrn_n_u16(vreinterpretq_u16_u8(found), 4)), 0);
+		if (mask != 0)
+			return ptr + (__builtin_ctzll(mask) >> 2);
+	}
+	return find_line_break_scalar(ptr, end);
+}
+
+#endif // SIMD_KERNELS_NEON
+
+
+// the plain C kernels, until select_kernels() has run
+SimdKernelSet gSimdKernels = {
+	"scalar",
+	count_equal_prefix_scalar,
+	count_equal_suffix_scalar,
+	find_line_break_scalar
+};
+
+
+static bool
+select_kernels()
+{
+#if defined(SIMD_KERNELS_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		gSimdKernels.name = "avx2";
+		gSimdKernels.prefix = count_equal_prefix_avx2;
+		gSimdKernels.suffix = count_equal_suffix_avx2;
+		gSimdKernels.lineBreak = find_line_break_avx2;
+	} else if (__builtin_cpu_supports("sse2")) {
+		gSimdKernels.name = "sse2";
+		gSimdKernels.prefix = count_equal_prefix_sse2;
+		gSimdKernels.suffix = count_equal_suffix_sse2;
+		gSimdKernels.lineBreak = find_line_break_sse2;
+	}
+#elif defined(SIMD_KERNELS_NEON)
+	gSimdKernels.name = "neon";
+	gSimdKernels.prefix = count_equal_prefix_neon;
+	gSimdKernels.suffix = count_equal_suffix_neon;
+	gSimdKernels.lineBreak = find_line_break_neon;
+#endif
+	return true;
+}
+
+
+// runs before main(), so no comparison ever pays for choosing
+static bool sKernelsSelected = select_kernels();
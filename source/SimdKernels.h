@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*
+ *	Mismatch search over element ID arrays, and line break search in text.
+ *	The best implementation for the running CPU (AVX2, SSE2, NEON or plain C)
+ *	is picked once by a static initializer, before any comparison runs, and
+ *	is called through a function pointer. The first few elements are
+ *	compared inline: most runs of equal lines end within them, and a call
+ *	costs more than such a run.
+ */
+
+typedef size_t (*count_equal_func)(const uint32_t* a, const uint32_t* b, size_t count);
+typedef const char* (*find_line_break_func)(const char* begin, const char* end);
+
+struct SimdKernelSet {
+	const char*				name;
+	count_equal_func		prefix;
+	count_equal_func		suffix;
+	find_line_break_func	lineBreak;
+};
+
+extern SimdKernelSet gSimdKernels;
+
+// elements compared inline before the kernel is called
+static const size_t kInlineCompareCount = 8;
+
+// shorter ranges of text are searched inline
+static const size_t kInlineSearchLength = 16;
+
+
+// Returns the number of equal elements at the start of a and b, at most
+// count.
+inline size_t
+CountEqualPrefix(const uint32_t* a, const uint32_t* b, size_t count)
+{
+	size_t inlineCount = count < kInlineCompareCount ? count : kInlineCompareCount;
+	size_t index;
+	for (index = 0; index < inlineCount; index++) {
+		if (a[index] != b[index])
+			return index;
+	}
+	if (index == count)
+		return count;
+	return index + gSimdKernels.prefix(a + index, b + index, count - index);
+}
+
+
+// Returns the number of equal elements at the end of a[0, count) and
+// b[0, count).
+inline size_t
+CountEqualSuffix(const uint32_t* a, const uint32_t* b, size_t count)
+{
+	size_t inlineCount = count < kInlineCompareCount ? count : kInlineCompareCount;
+	size_t index;
+	for (index = 0; index < inlineCount; index++) {
+		if (a[count - 1 - index] != b[count - 1 - index])
+			return index;
+	}
+	if (index == count)
+		return count;
+	return index + gSimdKernels.suffix(a, b, count - index);
+}
+
+
+// Returns the first '\r' or '\n' in [begin, end), or end if there is none.
+inline const char*
+FindLineBreak(const char* begin, const char* end)
+{
+	if (static_cast<size_t>(end - begin) < kInlineSearchLength) {
+		const char* ptr = begin;
+		while (ptr < end && *ptr != '\n' && *ptr != '\r')
+			ptr++;
+		return ptr;
+	}
+	return gSimdKernels.lineBreak(begin, end);
+}
+
+
+// Name of the implementation in use, for diagnostics.
+inline const char*
+GetSimdKernelName()
+{
+	return gSimdKernels.name;
+}
+
+#endif // SIMDKERNELS_H
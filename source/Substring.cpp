@@ -10,25 +10,38 @@
 #include <string.h>
 
 
-Substring::Substring(char* begin, char* end)
+const uint64_t Substring::kNoFingerprint;
+
+Substring::Substring(const char* begin, const char* end)
 {
 	this->begin = begin;
 	this->end = end;
+	this->fingerprint = kNoFingerprint;
 }
 
 
-Substring::Substring(char* cstring)
+Substring::Substring(const char* begin, const char* end, uint64_t fingerprint)
+{
+	this->begin = begin;
+	this->end = end;
+	this->fingerprint = fingerprint;
+}
+
+
+Substring::Substring(const char* cstring)
 {
 	this->begin = cstring;
 	this->end = cstring + strlen(cstring);
+	this->fingerprint = kNoFingerprint;
 }
 
 
-Substring::Substring(char* cstring, int maxLength)
+Substring::Substring(const char* cstring, int maxLength)
 {
 	this->begin = cstring;
 	int len = strlen(cstring);
 	this->end = cstring + ((len > maxLength) ? maxLength : len);
+	this->fingerprint = kNoFingerprint;
 }
 
 
@@ -36,6 +49,7 @@ Substring::Substring(const Substring& other)
 {
 	this->begin = other.begin;
 	this->end = other.end;
+	this->fingerprint = other.fingerprint;
 }
 
 
@@ -45,6 +59,7 @@ Substring::operator=(const Substring& other)
 	if (this != &other) {
 		this->begin = other.begin;
 		this->end = other.end;
+		this->fingerprint = other.fingerprint;
 	}
 	return *this;
 }
@@ -56,13 +71,39 @@ Substring::IsSameString(const Substring& other) const
 	if (Length() != other.Length())
 		return false;
 
-	char* ch1;
-	char* ch2;
-	for (ch1 = begin, ch2 = other.begin; ch1 < end; ch1++, ch2++) {
-		if (ch2 >= other.end)
-			return false;
-		if (*ch1 != *ch2)
-			return false;
+	// different fingerprints prove a difference, equal ones do not
+	if (fingerprint != kNoFingerprint && other.fingerprint != kNoFingerprint
+		&& fingerprint != other.fingerprint)
+		return false;
+
+	return memcmp(begin, other.begin, Length()) == 0;
+}
+
+
+/*
+ *	A 64-bit hash of [begin, end), taken a word at a time. It never returns
+ *	kNoFingerprint.
+ */
+/*static*/ uint64_t
+Substring::ComputeFingerprint(const char* begin, const char* end)
+{
+	const uint64_t kMultiplier = 0x9e3779b97f4a7c15ULL;
+
+	uint64_t hash = static_cast<uint64_t>(end - begin) * kMultiplier;
+	const char* ptr = begin;
+	for (; end - ptr >= 8; ptr += 8) {
+		uint64_t word;
+		memcpy(&word, ptr, sizeof(word));
+		hash = (hash ^ word) * kMultiplier;
+		hash ^= hash >> 29;
 	}
-	return true;
+	if (ptr < end) {
+		uint64_t word = 0;
+		memcpy(&word, ptr, end - ptr);
+		hash = (hash ^ word) * kMultiplier;
+		hash ^= hash >> 29;
+	}
+	hash ^= hash >> 32;
+
+	return (hash != kNoFingerprint) ? hash : 1;
 }
@@ -9,12 +9,16 @@
 #ifndef SUBSTRING_H
 #define SUBSTRING_H
 
+#include <stdint.h>
+
 
 class Substring {
 public:
-					Substring(char* begin, char* end);
-					Substring(char* cstring);
-					Substring(char* cstring, int maxLength);
+					Substring(const char* begin, const char* end);
+					Substring(const char* begin, const char* end,
+						uint64_t fingerprint);
+					Substring(const char* cstring);
+					Substring(const char* cstring, int maxLength);
 					Substring(const Substring& other);
 
 	Substring&		operator=(const Substring& other);
@@ -22,6 +26,7 @@ public:
 	const char*		Begin() const	{ return begin; }
 	const char*		End() const		{ return end; }
 	int				Length() const { return end - begin; }
+	uint64_t		Fingerprint() const	{ return fingerprint; }
 
 	bool			IsSameString(const Substring& other) const;
 	bool			operator==(const Substring& other) const
@@ -29,9 +34,14 @@ public:
 	bool			operator!=(const Substring& other) const
 						{ return !IsSameString(other); }
 
+	static const uint64_t	kNoFingerprint = 0;
+	static	uint64_t		ComputeFingerprint(const char* begin,
+								const char* end);
+
 private:
-	char*			begin;
-	char*			end;
+	const char*		begin;
+	const char*		end;
+	uint64_t		fingerprint;	//< kNoFingerprint if not known
 };
 
 #endif // SUBSTRING_H
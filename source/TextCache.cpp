@@ -0,0 +1,222 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "TextCache.h"
+
+#include <sys/stat.h>
+
+#include "DiffEngine.h"
+#include "Exception.h"
+#include "ExceptionCode.h"
+
+
+// how often a request waiting for another one's load checks if it is canceled
+static const long kCancelCheckInterval = 100000;	// microseconds
+
+
+class TextCache::Entry : public LineSeparatedText {
+public:
+	Entry()
+		:
+		fSize(0),
+		fReferences(1),
+		fIsLoading(true),
+		fHasFailed(false),
+		fIsListed(false)
+	{
+		fModified.tv_sec = 0;
+		fModified.tv_nsec = 0;
+
+		// the line interner of every window needs them
+		SetFingerprinting(true);
+
+		// the windows draw from the text for as long as they are open, also
+		// after the file has been cut short by an editor saving it
+		SetMapping(false);
+	}
+
+	bool IsVersionOf(const struct stat& st) const
+	{
+		return fSize == st.st_size && fModified.tv_sec == st.st_mtim.tv_sec
+			&& fModified.tv_nsec == st.st_mtim.tv_nsec;
+	}
+
+	node_ref			fNodeRef;
+	struct timespec		fModified;
+	off_t				fSize;
+	int32				fReferences;	//< guarded by the cache's lock
+	bool				fIsLoading;
+	bool				fHasFailed;
+	bool				fIsListed;		//< in fEntries
+};
+
+
+TextCache::TextCache(LineIndexCache* indexCache)
+{
+	fIndexCache = indexCache;
+	pthread_mutex_init(&fLock, NULL);
+	pthread_cond_init(&fLoaded, NULL);
+}
+
+
+TextCache::~TextCache()
+{
+	EntryMap::iterator iterator;
+	for (iterator = fEntries.begin(); iterator != fEntries.end(); iterator++)
+		delete iterator->second;
+
+	pthread_cond_destroy(&fLoaded);
+	pthread_mutex_destroy(&fLock);
+}
+
+
+/*
+ *	Returns the text of the file at path, loading it unless the current
+ *	version is already loaded or being loaded. Every text returned has to be
+ *	given back to Release(). Throws the exceptions of
+ *	LineSeparatedText::Load().
+ */
+const LineSeparatedText*
+TextCache::Acquire(const BPath& path, ThreadPool* pool, DiffProgress* progress)
+{
+	struct stat st;
+	if (stat(path.Path(), &st) != 0 || !S_ISREG(st.st_mode)) {
+		// pipes and devices have no version to tell, they are read each time
+		Entry* entry = new Entry;
+		entry->SetIndexCache(fIndexCache);
+		entry->SetProgress(progress);
+		try {
+			entry->Load(path.Path(), pool);
+		} catch (...) {
+			delete entry;
+			throw;
+		}
+		entry->SetProgress(NULL);
+		entry->fIsLoading = false;
+		return entry;
+	}
+
+	node_ref nodeRef;
+	nodeRef.device = st.st_dev;
+	nodeRef.node = st.st_ino;
+
+	pthread_mutex_lock(&fLock);
+	while (true) {
+		EntryMap::iterator found = fEntries.find(nodeRef);
+		if (found == fEntries.end())
+			break;
+
+		Entry* entry = found->second;
+		if (!entry->fIsLoading && !entry->IsVersionOf(st)) {
+			// the file has changed, its users keep the previous version
+			entry->fIsListed = false;
+			fEntries.erase(found);
+			break;
+		}
+
+		entry->fReferences++;
+		while (entry->fIsLoading) {
+			if (progress != NULL && progress->IsCanceled()) {
+				// the other window's load may take long, don't wait for it
+				_Unreference(entry);
+				pthread_mutex_unlock(&fLock);
+				throw new Exception(EXCEPTION_CANCELED);
+			}
+			_WaitLoaded(progress != NULL);
+		}
+		if (!entry->fHasFailed && entry->IsVersionOf(st)) {
+			pthread_mutex_unlock(&fLock);
+			return entry;
+		}
+
+		// look again, another version or another attempt is needed
+		_Unreference(entry);
+	}
+
+	Entry* entry = new Entry;
+	entry->fNodeRef = nodeRef;
+	entry->fModified = st.st_mtim;
+	entry->fSize = st.st_size;
+	entry->fIsListed = true;
+	fEntries[nodeRef] = entry;
+	pthread_mutex_unlock(&fLock);
+
+	// the others asking for this file wait until it is loaded
+	entry->SetIndexCache(fIndexCache);
+	entry->SetProgress(progress);
+	try {
+		entry->Load(path.Path(), pool);
+	} catch (...) {
+		pthread_mutex_lock(&fLock);
+		entry->SetProgress(NULL);
+		entry->fIsLoading = false;
+		entry->fHasFailed = true;
+		if (entry->fIsListed) {
+			fEntries.erase(entry->fNodeRef);
+			entry->fIsListed = false;
+		}
+		pthread_cond_broadcast(&fLoaded);
+		_Unreference(entry);
+		pthread_mutex_unlock(&fLock);
+		throw;
+	}
+
+	pthread_mutex_lock(&fLock);
+	entry->SetProgress(NULL);
+	entry->fIsLoading = false;
+	pthread_cond_broadcast(&fLoaded);
+	pthread_mutex_unlock(&fLock);
+	return entry;
+}
+
+
+void
+TextCache::Release(const LineSeparatedText* text)
+{
+	if (text == NULL)
+		return;
+
+	pthread_mutex_lock(&fLock);
+	_Unreference(static_cast<Entry*>(const_cast<LineSeparatedText*>(text)));
+	pthread_mutex_unlock(&fLock);
+}
+
+
+/*
+ *	Waits until a load has ended, or only for a while if the caller has to
+ *	check whether it is canceled. fLock must be held.
+ */
+void
+TextCache::_WaitLoaded(bool timed)
+{
+	if (!timed) {
+		pthread_cond_wait(&fLoaded, &fLock);
+		return;
+	}
+
+	struct timespec timeout;
+	clock_gettime(CLOCK_REALTIME, &timeout);
+	timeout.tv_nsec += kCancelCheckInterval * 1000;
+	if (timeout.tv_nsec >= 1000000000) {
+		timeout.tv_sec++;
+		timeout.tv_nsec -= 1000000000;
+	}
+	pthread_cond_timedwait(&fLoaded, &fLock, &timeout);
+}
+
+
+/*
+ *	Drops a reference, and the entry with the last one. fLock must be held.
+ */
+void
+TextCache::_Unreference(Entry* entry)
+{
+	if (--entry->fReferences > 0)
+		return;
+
+	if (entry->fIsListed)
+		fEntries.erase(entry->fNodeRef);
+	delete entry;
+}
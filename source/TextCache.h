@@ -0,0 +1,59 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef TEXTCACHE_H
+#define TEXTCACHE_H
+
+#include <map>
+
+#include <Node.h>
+#include <Path.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "LineSeparatedText.h"
+
+class DiffProgress;
+class LineIndexCache;
+class ThreadPool;
+
+
+/*
+ *	Loaded texts, shared by all windows. A file is loaded and split once,
+ *	however many windows compare it; they all get the same copy, line index
+ *	and fingerprints.
+ *
+ *	Texts are looked up by node_ref, and are only reused while the file has
+ *	the same modification time and size. A changed file is loaded again,
+ *	the windows that still show the previous version keep it until they
+ *	release it. A text is unloaded as soon as its last user releases it.
+ *	All methods may be called from several threads at once. A request that
+ *	waits for another one to load the file gives up when its own progress
+ *	is canceled.
+ */
+class TextCache {
+public:
+							TextCache(LineIndexCache* indexCache = NULL);
+							~TextCache();
+
+	const	LineSeparatedText*	Acquire(const BPath& path, ThreadPool* pool = NULL,
+								DiffProgress* progress = NULL);
+			void			Release(const LineSeparatedText* text);
+
+private:
+	class Entry;
+	typedef std::map<node_ref, Entry*>	EntryMap;
+
+			void			_WaitLoaded(bool timed);
+			void			_Unreference(Entry* entry);
+
+private:
+			LineIndexCache*	fIndexCache;
+			EntryMap		fEntries;
+			pthread_mutex_t	fLock;
+			pthread_cond_t	fLoaded;
+};
+
+#endif // TEXTCACHE_H
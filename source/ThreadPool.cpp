@@ -0,0 +1,358 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <stdint.h>
+#include <unistd.h>
+
+
+TaskGroup::TaskGroup()
+{
+	pthread_mutex_init(&fLock, NULL);
+	pthread_cond_init(&fFinished, NULL);
+	fPending = 0;
+}
+
+
+TaskGroup::~TaskGroup()
+{
+	pthread_cond_destroy(&fFinished);
+	pthread_mutex_destroy(&fLock);
+}
+
+
+void
+TaskGroup::Wait()
+{
+	pthread_mutex_lock(&fLock);
+	while (fPending > 0)
+		pthread_cond_wait(&fFinished, &fLock);
+	pthread_mutex_unlock(&fLock);
+}
+
+
+void
+TaskGroup::_Add()
+{
+	pthread_mutex_lock(&fLock);
+	fPending++;
+	pthread_mutex_unlock(&fLock);
+}
+
+
+void
+TaskGroup::_Done()
+{
+	pthread_mutex_lock(&fLock);
+	fPending--;
+	if (fPending == 0)
+		pthread_cond_broadcast(&fFinished);
+	pthread_mutex_unlock(&fLock);
+}
+
+
+ThreadPool::ThreadPool(int threadCount)
+{
+	if (threadCount <= 0)
+		threadCount = CountCPUs();
+
+	pthread_mutex_init(&fLock, NULL);
+	pthread_cond_init(&fWorkAvailable, NULL);
+	pthread_key_create(&fWorkerKey, NULL);
+	fQueuedTasks = 0;
+	fNextWorker = 0;
+	fQuitting = false;
+
+	int index;
+	for (index = 0; index < threadCount; index++) {
+		Worker* worker = new Worker;
+		pthread_mutex_init(&worker->lock, NULL);
+		fWorkers.push_back(worker);
+	}
+
+	// the start records must not move while the threads pick them up
+	fStarts.resize(threadCount);
+	for (index = 0; index < threadCount; index++) {
+		fStarts[index].pool = this;
+		fStarts[index].index = index;
+
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, &_WorkerEntry, &fStarts[index]) != 0)
+			break;
+		fThreads.push_back(thread);
+	}
+}
+
+
+ThreadPool::~ThreadPool()
+{
+	pthread_mutex_lock(&fLock);
+	fQuitting = true;
+	pthread_cond_broadcast(&fWorkAvailable);
+	pthread_mutex_unlock(&fLock);
+
+	size_t index;
+	for (index = 0; index < fThreads.size(); index++)
+		pthread_join(fThreads[index], NULL);
+
+	for (index = 0; index < fWorkers.size(); index++) {
+		pthread_mutex_destroy(&fWorkers[index]->lock);
+		delete fWorkers[index];
+	}
+
+	pthread_key_delete(fWorkerKey);
+	pthread_cond_destroy(&fWorkAvailable);
+	pthread_mutex_destroy(&fLock);
+}
+
+
+void
+ThreadPool::Submit(PoolTask* task, TaskGroup* group)
+{
+	group->_Add();
+	task->fGroup = group;
+
+	if (fThreads.empty()) {
+		// no worker could be started, run it right away
+		_RunTask(task);
+		return;
+	}
+
+	int workerIndex = _CurrentWorker();
+	if (workerIndex < 0) {
+		pthread_mutex_lock(&fLock);
+		workerIndex = fNextWorker;
+		fNextWorker = (fNextWorker + 1) % fThreads.size();
+		pthread_mutex_unlock(&fLock);
+	}
+
+	Worker* worker = fWorkers[workerIndex];
+	pthread_mutex_lock(&worker->lock);
+	worker->tasks.push_back(task);
+	pthread_mutex_unlock(&worker->lock);
+
+	pthread_mutex_lock(&fLock);
+	fQueuedTasks++;
+	pthread_cond_signal(&fWorkAvailable);
+	pthread_mutex_unlock(&fLock);
+}
+
+
+void
+ThreadPool::SubmitJob(PoolTask* job, TaskGroup* group)
+{
+	group->_Add();
+	job->fGroup = group;
+
+	if (fThreads.empty()) {
+		_RunTask(job);
+		return;
+	}
+
+	pthread_mutex_lock(&fLock);
+	fJobs.push_back(job);
+	pthread_cond_signal(&fWorkAvailable);
+	pthread_mutex_unlock(&fLock);
+}
+
+
+/*
+ *	Takes a job out of the queue, unless it has already been started, and
+ *	counts it as done. Returns whether it was still queued.
+ */
+bool
+ThreadPool::Withdraw(PoolTask* job)
+{
+	pthread_mutex_lock(&fLock);
+	std::deque<PoolTask*>::iterator found = std::find(fJobs.begin(), fJobs.end(), job);
+	bool queued = found != fJobs.end();
+	if (queued)
+		fJobs.erase(found);
+	pthread_mutex_unlock(&fLock);
+
+	if (queued)
+		job->fGroup->_Done();
+	return queued;
+}
+
+
+void
+ThreadPool::Wait(TaskGroup* group)
+{
+	int workerIndex = _CurrentWorker();
+	while (true) {
+		pthread_mutex_lock(&group->fLock);
+		int pending = group->fPending;
+		pthread_mutex_unlock(&group->fLock);
+		if (pending == 0)
+			return;
+
+		// help out instead of blocking a thread, but only with the group's
+		// own tasks: any other task might wait for something the caller
+		// has yet to finish
+		PoolTask* task = _TakeTask(workerIndex, group);
+		if (task != NULL) {
+			_RunTask(task);
+			continue;
+		}
+
+		group->Wait();
+		return;
+	}
+}
+
+
+/*static*/ int
+ThreadPool::CountCPUs()
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count < 1)
+		return 1;
+	return count;
+}
+
+
+/*static*/ void*
+ThreadPool::_WorkerEntry(void* data)
+{
+	WorkerStart* start = static_cast<WorkerStart*>(data);
+	ThreadPool* pool = start->pool;
+	int index = start->index;
+
+	pthread_setspecific(pool->fWorkerKey, reinterpret_cast<void*>(intptr_t(index + 1)));
+	pool->_WorkerLoop(index);
+	return NULL;
+}
+
+
+void
+ThreadPool::_WorkerLoop(int workerIndex)
+{
+	while (true) {
+		PoolTask* task = _TakeTask(workerIndex, NULL);
+		if (task == NULL)
+			task = _TakeJob();
+		if (task != NULL) {
+			_RunTask(task);
+			continue;
+		}
+
+		pthread_mutex_lock(&fLock);
+		while (fQueuedTasks <= 0 && fJobs.empty() && !fQuitting)
+			pthread_cond_wait(&fWorkAvailable, &fLock);
+		bool quitting = fQuitting && fQueuedTasks <= 0 && fJobs.empty();
+		pthread_mutex_unlock(&fLock);
+
+		if (quitting)
+			return;
+	}
+}
+
+
+/*
+ *	Takes a queued task, one of group unless that is NULL.
+ */
+PoolTask*
+ThreadPool::_TakeTask(int workerIndex, TaskGroup* group)
+{
+	PoolTask* task = NULL;
+	int workerCount = fWorkers.size();
+
+	// own tasks first, newest first
+	if (workerIndex >= 0) {
+		Worker* worker = fWorkers[workerIndex];
+		pthread_mutex_lock(&worker->lock);
+		task = _TakeFrom(worker->tasks, group, true);
+		pthread_mutex_unlock(&worker->lock);
+	}
+
+	// then steal the oldest task of somebody else
+	int offset;
+	for (offset = 1; task == NULL && offset <= workerCount; offset++) {
+		int victimIndex = (workerIndex + offset) % workerCount;
+		if (victimIndex < 0)
+			victimIndex += workerCount;
+		if (victimIndex == workerIndex)
+			continue;
+
+		Worker* victim = fWorkers[victimIndex];
+		pthread_mutex_lock(&victim->lock);
+		task = _TakeFrom(victim->tasks, group, false);
+		pthread_mutex_unlock(&victim->lock);
+	}
+
+	if (task != NULL) {
+		pthread_mutex_lock(&fLock);
+		fQueuedTasks--;
+		pthread_mutex_unlock(&fLock);
+	}
+	return task;
+}
+
+
+/*
+ *	Takes the newest or the oldest task of group out of tasks, or of any
+ *	group if it is NULL. The lock of the deque's worker must be held.
+ */
+/*static*/ PoolTask*
+ThreadPool::_TakeFrom(std::deque<PoolTask*>& tasks, TaskGroup* group, bool newest)
+{
+	if (tasks.empty())
+		return NULL;
+
+	if (group == NULL) {
+		PoolTask* task = newest ? tasks.back() : tasks.front();
+		if (newest)
+			tasks.pop_back();
+		else
+			tasks.pop_front();
+		return task;
+	}
+
+	size_t count = tasks.size();
+	size_t step;
+	for (step = 0; step < count; step++) {
+		size_t index = newest ? count - 1 - step : step;
+		PoolTask* task = tasks[index];
+		if (task->fGroup == group) {
+			tasks.erase(tasks.begin() + index);
+			return task;
+		}
+	}
+	return NULL;
+}
+
+
+PoolTask*
+ThreadPool::_TakeJob()
+{
+	PoolTask* job = NULL;
+	pthread_mutex_lock(&fLock);
+	if (!fJobs.empty()) {
+		job = fJobs.front();
+		fJobs.pop_front();
+	}
+	pthread_mutex_unlock(&fLock);
+	return job;
+}
+
+
+void
+ThreadPool::_RunTask(PoolTask* task)
+{
+	// the task may be gone as soon as its group is done
+	TaskGroup* group = task->fGroup;
+	task->Run();
+	group->_Done();
+}
+
+
+int
+ThreadPool::_CurrentWorker() const
+{
+	return static_cast<int>(reinterpret_cast<intptr_t>(pthread_getspecific(fWorkerKey))) - 1;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <deque>
+#include <stddef.h>
+#include <vector>
+
+#include <pthread.h>
+
+
+class TaskGroup;
+
+
+class PoolTask {
+public:
+						PoolTask() { fGroup = NULL; }
+	virtual				~PoolTask() {}
+
+	virtual	void		Run() = 0;
+
+private:
+	friend class ThreadPool;
+
+			TaskGroup*	fGroup;
+};
+
+
+/*
+ *	Counts the unfinished tasks of one batch, so that the submitter can wait
+ *	for all of them with ThreadPool::Wait().
+ */
+class TaskGroup {
+public:
+						TaskGroup();
+						~TaskGroup();
+
+			// blocks until the group is done, without running any tasks
+			void		Wait();
+
+private:
+	friend class ThreadPool;
+
+			void		_Add();
+			void		_Done();
+
+			pthread_mutex_t	fLock;
+			pthread_cond_t	fFinished;
+			int			fPending;
+};
+
+
+/*
+ *	Work-stealing thread pool. Every worker owns a task deque: tasks submitted
+ *	by a worker go to its own deque and are taken from its back, idle
+ *	workers steal from the front of the others. Tasks submitted from outside
+ *	the pool are handed out round robin.
+ *
+ *	Tasks are owned by the submitter and must stay alive until their group
+ *	has been waited for. A thread waiting for a group runs the group's queued
+ *	tasks in the meantime, so tasks may submit and wait for subtasks
+ *	themselves. It runs no other tasks: one of them might wait for something
+ *	the waiting thread has yet to finish, like a text it is loading.
+ *
+ *	Jobs are long tasks that are independent of each other, like a whole
+ *	comparison. They wait in a queue of their own and are started in order,
+ *	one per idle worker, and only after the tasks already queued. A thread
+ *	that waits for a group never starts a job, so no job is held up behind
+ *	another, and several jobs share the workers instead of oversubscribing
+ *	the CPU.
+ */
+class ThreadPool {
+public:
+						ThreadPool(int threadCount = 0);
+						~ThreadPool();
+
+			int			CountThreads() const { return fThreads.size(); }
+
+			void		Submit(PoolTask* task, TaskGroup* group);
+			void		SubmitJob(PoolTask* job, TaskGroup* group);
+			bool		Withdraw(PoolTask* job);
+			void		Wait(TaskGroup* group);
+
+	static	int			CountCPUs();
+
+private:
+	struct Worker {
+		pthread_mutex_t		lock;
+		std::deque<PoolTask*>	tasks;
+	};
+
+	static	void*		_WorkerEntry(void* data);
+			void		_WorkerLoop(int workerIndex);
+			PoolTask*	_TakeTask(int workerIndex, TaskGroup* group);
+	static	PoolTask*	_TakeFrom(std::deque<PoolTask*>& tasks,
+							TaskGroup* group, bool newest);
+			PoolTask*	_TakeJob();
+			void		_RunTask(PoolTask* task);
+			int			_CurrentWorker() const;
+
+private:
+	struct WorkerStart {
+		ThreadPool*	pool;
+		int			index;
+	};
+
+	std::vector<pthread_t>		fThreads;
+	std::vector<Worker*>		fWorkers;
+	std::vector<WorkerStart>	fStarts;
+
+	std::deque<PoolTask*>		fJobs;		//< guarded by fLock
+
+			pthread_mutex_t	fLock;
+			pthread_cond_t	fWorkAvailable;
+			int			fQueuedTasks;
+			int			fNextWorker;
+			bool		fQuitting;
+			pthread_key_t	fWorkerKey;
+};
+
+#endif // THREADPOOL_H
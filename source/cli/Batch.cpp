@@ -0,0 +1,380 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "Batch.h"
+
+#include <set>
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "Comparison.h"
+#include "DiffOutput.h"
+#include "Exception.h"
+#include "ExceptionCode.h"
+
+
+enum {
+	STATUS_SAME = 0,
+	STATUS_DIFFERENT,
+	STATUS_ONLY,
+	STATUS_ERROR,
+	STATUS_PENDING,
+};
+
+static const char* kStatusNames[] = { "same", "differ", "only", "error" };
+
+
+static std::string
+describe_exception(Exception* ex)
+{
+	switch (ex->GetCode()) {
+		case EXCEPTION_MEMORY:
+			return strerror(ENOMEM);
+
+		case EXCEPTION_FILE_OPEN:
+		case EXCEPTION_FILE_READ:
+		{
+			FileException* fileException = static_cast<FileException*>(ex);
+			int status = fileException->GetStatus();
+			return std::string(fileException->GetPath()) + ": "
+				+ strerror(status != 0 ? status : EIO);
+		}
+
+		default:
+			return "the comparison has failed";
+	}
+}
+
+
+class Batch::Job : public PoolTask {
+public:
+	Job(Batch* batch, const std::string& path0, const std::string& path1)
+		:
+		fStatus(STATUS_PENDING),
+		fRemoved(0),
+		fAdded(0),
+		fElapsed(0),
+		fBatch(batch)
+	{
+		fPaths[0] = path0;
+		fPaths[1] = path1;
+	}
+
+	virtual void Run()
+	{
+		int status = fStatus;
+		if (status == STATUS_PENDING) {
+			int64_t start = DiffEngine::CurrentTime();
+			status = _Compare();
+			fElapsed = DiffEngine::CurrentTime() - start;
+		}
+		fBatch->_JobFinished(this, status);
+	}
+
+	std::string			fPaths[2];		//< empty if missing
+	int					fStatus;		//< guarded by the batch's lock
+	int					fRemoved;
+	int					fAdded;
+	int64_t				fElapsed;		//< microseconds
+	std::string			fReason;		//< why it failed
+
+private:
+	int _Compare()
+	{
+		if (fPaths[0].empty() || fPaths[1].empty())
+			return STATUS_ONLY;
+
+		Comparison comparison(fBatch->fPool, fBatch->fAlgorithm);
+		try {
+			comparison.Load(fPaths[0].c_str(), fPaths[1].c_str());
+			if (comparison.IsIdentical())
+				return STATUS_SAME;
+
+			// only the counts are kept, not the script
+			LineCounter counter;
+			comparison.Detect(&counter);
+			fRemoved = counter.CountRemoved();
+			fAdded = counter.CountAdded();
+			return STATUS_DIFFERENT;
+		} catch (Exception* ex) {
+			fReason = describe_exception(ex);
+			ex->Delete();
+			return STATUS_ERROR;
+		}
+	}
+
+	Batch*				fBatch;
+};
+
+
+// #pragma mark -
+
+
+Batch::Batch(ThreadPool* pool, diff_algorithm algorithm)
+{
+	fPool = pool;
+	fAlgorithm = algorithm;
+	fOnlyChanges = false;
+	fOutput = NULL;
+	fNextReport = 0;
+	memset(fCounts, 0, sizeof(fCounts));
+	fRemoved = 0;
+	fAdded = 0;
+	pthread_mutex_init(&fLock, NULL);
+}
+
+
+Batch::~Batch()
+{
+	JobVector::iterator iterator;
+	for (iterator = fJobs.begin(); iterator != fJobs.end(); iterator++)
+		delete *iterator;
+
+	pthread_mutex_destroy(&fLock);
+}
+
+
+void
+Batch::AddPair(const char* path0, const char* path1)
+{
+	fJobs.push_back(new Job(this, path0, path1));
+}
+
+
+/*
+ *	Adds the pairs listed in a manifest: one pair per line, the two paths
+ *	separated by a tab. Empty lines and those starting with '#' are skipped.
+ *	A line that is no pair is reported as a failed one, so that it cannot
+ *	go unnoticed. Throws a FileException if the manifest cannot be read.
+ */
+void
+Batch::AddManifest(const char* path)
+{
+	FILE* file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+	if (file == NULL)
+		throw new FileException(EXCEPTION_FILE_OPEN, path, errno);
+
+	char* line = NULL;
+	size_t size = 0;
+	ssize_t length;
+	int lineNumber = 0;
+	while ((length = getline(&line, &size, file)) >= 0) {
+		lineNumber++;
+		while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+			line[--length] = '\0';
+		if (length == 0 || line[0] == '#')
+			continue;
+
+		char* separator = strchr(line, '\t');
+		if (separator == NULL || separator == line || separator[1] == '\0'
+			|| strchr(separator + 1, '\t') != NULL) {
+			char reason[64];
+			snprintf(reason, sizeof(reason), "line %d of the manifest is no pair",
+				lineNumber);
+			_AddFailure(line, "", reason);
+			continue;
+		}
+
+		*separator = '\0';
+		AddPair(line, separator + 1);
+	}
+
+	int status = ferror(file) ? errno : 0;
+	free(line);
+	if (file != stdin)
+		fclose(file);
+	if (status != 0)
+		throw new FileException(EXCEPTION_FILE_READ, path, status);
+}
+
+
+/*
+ *	Collects the regular files below directory, by their path relative to
+ *	root. Symbolic links to files are followed, those to directories are
+ *	not.
+ */
+static void
+collect_files(const std::string& root, const std::string& directory,
+	std::set<std::string>& files)
+{
+	std::string path = directory.empty() ? root : root + "/" + directory;
+	DIR* dir = opendir(path.c_str());
+	if (dir == NULL)
+		throw new FileException(EXCEPTION_FILE_OPEN, path.c_str(), errno);
+
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL) {
+		if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+			continue;
+
+		std::string relative = directory.empty()
+			? std::string(entry->d_name) : directory + "/" + entry->d_name;
+		std::string entryPath = root + "/" + relative;
+		struct stat st;
+		if (lstat(entryPath.c_str(), &st) != 0)
+			continue;
+
+		if (S_ISDIR(st.st_mode)) {
+			try {
+				collect_files(root, relative, files);
+			} catch (...) {
+				closedir(dir);
+				throw;
+			}
+		} else if (S_ISREG(st.st_mode)
+			|| (S_ISLNK(st.st_mode) && stat(entryPath.c_str(), &st) == 0
+				&& S_ISREG(st.st_mode)))
+			files.insert(relative);
+	}
+	closedir(dir);
+}
+
+
+/*
+ *	Pairs the files below two directories by their relative path, in sorted
+ *	order. A file found below only one of them is reported as such. Throws
+ *	a FileException if a directory cannot be read.
+ */
+void
+Batch::AddDirectories(const char* root0, const char* root1)
+{
+	std::set<std::string> files[2];
+	collect_files(root0, "", files[0]);
+	collect_files(root1, "", files[1]);
+
+	std::set<std::string> all(files[0]);
+	all.insert(files[1].begin(), files[1].end());
+
+	std::set<std::string>::const_iterator iterator;
+	for (iterator = all.begin(); iterator != all.end(); iterator++) {
+		std::string path0;
+		std::string path1;
+		if (files[0].count(*iterator) != 0)
+			path0 = std::string(root0) + "/" + *iterator;
+		if (files[1].count(*iterator) != 0)
+			path1 = std::string(root1) + "/" + *iterator;
+		fJobs.push_back(new Job(this, path0, path1));
+	}
+}
+
+
+/*
+ *	Runs all comparisons and writes the report to output as they finish.
+ *	Returns the exit status of diff(1): that of the worst pair.
+ */
+int
+Batch::Run(OutputBuffer& output)
+{
+	int64_t start = DiffEngine::CurrentTime();
+
+	pthread_mutex_lock(&fLock);
+	fOutput = &output;
+	fNextReport = 0;
+	pthread_mutex_unlock(&fLock);
+
+	JobVector::iterator iterator;
+	for (iterator = fJobs.begin(); iterator != fJobs.end(); iterator++)
+		fPool->SubmitJob(*iterator, &fGroup);
+	fGroup.Wait();
+
+	pthread_mutex_lock(&fLock);
+	_WriteSummary(DiffEngine::CurrentTime() - start);
+	output.Flush();
+	fOutput = NULL;
+	pthread_mutex_unlock(&fLock);
+
+	if (fCounts[STATUS_ERROR] > 0)
+		return EXIT_TROUBLE;
+	if (fCounts[STATUS_DIFFERENT] > 0 || fCounts[STATUS_ONLY] > 0)
+		return EXIT_DIFFERENT;
+	return EXIT_SAME;
+}
+
+
+void
+Batch::_AddFailure(const std::string& path0, const std::string& path1,
+	const std::string& reason)
+{
+	Job* job = new Job(this, path0, path1);
+	job->fStatus = STATUS_ERROR;
+	job->fReason = reason;
+	fJobs.push_back(job);
+}
+
+
+/*
+ *	Called by every job when it is done, with its status. Reports all finished jobs that are
+ *	next in order, so that the report keeps the order of the pairs however
+ *	the jobs are scheduled.
+ */
+void
+Batch::_JobFinished(Job* job, int status)
+{
+	pthread_mutex_lock(&fLock);
+	job->fStatus = status;
+	bool reported = false;
+	while (fNextReport < fJobs.size() && fJobs[fNextReport]->fStatus != STATUS_PENDING) {
+		const Job* next = fJobs[fNextReport++];
+		fCounts[next->fStatus]++;
+		fRemoved += next->fRemoved;
+		fAdded += next->fAdded;
+		if (!fOnlyChanges || next->fStatus != STATUS_SAME) {
+			_WriteReport(next);
+			reported = true;
+		}
+	}
+	if (reported)
+		fOutput->Flush();
+	pthread_mutex_unlock(&fLock);
+}
+
+
+/*
+ *	fLock must be held.
+ */
+void
+Batch::_WriteReport(const Job* job)
+{
+	char numbers[64];
+	if (job->fStatus == STATUS_DIFFERENT || job->fStatus == STATUS_SAME) {
+		snprintf(numbers, sizeof(numbers), "\t%d\t%d\t%.1f\t", job->fRemoved, job->fAdded,
+			job->fElapsed / 1000.0);
+	} else
+		strcpy(numbers, "\t-\t-\t-\t");
+
+	fOutput->Write(kStatusNames[job->fStatus]);
+	fOutput->Write(numbers);
+	fOutput->Write(job->fPaths[0].c_str(), job->fPaths[0].length());
+	fOutput->Write("\t");
+	fOutput->Write(job->fPaths[1].c_str(), job->fPaths[1].length());
+	if (job->fStatus == STATUS_ERROR) {
+		fOutput->Write("\t");
+		fOutput->Write(job->fReason.c_str(), job->fReason.length());
+	}
+	fOutput->Write("\n");
+}
+
+
+/*
+ *	fLock must be held.
+ */
+void
+Batch::_WriteSummary(int64_t elapsed)
+{
+	char summary[256];
+	snprintf(summary, sizeof(summary),
+		"# %d pairs: %d same, %d different, %d only on one side, %d failed; "
+		"%lld lines removed, %lld added; %.2f s\n",
+		static_cast<int>(fJobs.size()), fCounts[STATUS_SAME],
+		fCounts[STATUS_DIFFERENT], fCounts[STATUS_ONLY], fCounts[STATUS_ERROR],
+		static_cast<long long>(fRemoved), static_cast<long long>(fAdded),
+		elapsed / 1000000.0);
+	fOutput->Write(summary);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "DiffEngine.h"
+#include "ThreadPool.h"
+
+class OutputBuffer;
+
+
+/*
+ *	Many comparisons run on a thread pool, one job per pair of files. Each
+ *	job only keeps the size of the difference; its texts and script are
+ *	freed as soon as it is done.
+ *
+ *	The report is streamed while the jobs run, one line per pair in the
+ *	order the pairs were added:
+ *
+ *		status<TAB>removed<TAB>added<TAB>milliseconds<TAB>path1<TAB>path2
+ *
+ *	with status one of "same", "differ", "only" (the file is missing on one
+ *	side) or "error", which is followed by the reason. A summary follows as
+ *	a line starting with '#'.
+ */
+class Batch {
+public:
+						Batch(ThreadPool* pool,
+							diff_algorithm algorithm = DIFF_ALGORITHM_NP);
+						~Batch();
+
+			void		AddPair(const char* path0, const char* path1);
+			void		AddManifest(const char* path);
+			void		AddDirectories(const char* root0, const char* root1);
+
+			int			CountPairs() const { return fJobs.size(); }
+			void		SetOnlyChanges(bool onlyChanges)
+							{ fOnlyChanges = onlyChanges; }
+
+			int			Run(OutputBuffer& output);
+
+private:
+	class Job;
+	typedef std::vector<Job*>	JobVector;
+
+			void		_AddFailure(const std::string& path0,
+							const std::string& path1, const std::string& reason);
+			void		_JobFinished(Job* job, int status);
+			void		_WriteReport(const Job* job);
+			void		_WriteSummary(int64_t elapsed);
+
+private:
+			ThreadPool*	fPool;
+		diff_algorithm	fAlgorithm;
+			bool		fOnlyChanges;	//< leave out the identical pairs
+			JobVector	fJobs;
+			TaskGroup	fGroup;
+
+			pthread_mutex_t	fLock;		//< guards what follows
+			OutputBuffer*	fOutput;
+			size_t		fNextReport;	//< index of the first job not reported
+			int			fCounts[4];		//< pairs by status
+			int64_t		fRemoved;
+			int64_t		fAdded;
+};
+
+#endif // BATCH_H
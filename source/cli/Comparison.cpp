@@ -0,0 +1,85 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "Comparison.h"
+
+#include <string.h>
+
+
+Comparison::Comparison(ThreadPool* pool, diff_algorithm algorithm)
+	:
+	fSequences(&fInterner)
+{
+	fPool = pool;
+	fAlgorithm = algorithm;
+
+	// the interner hashes every line anyway, so do it while splitting
+	fTexts[0].SetFingerprinting(true);
+	fTexts[1].SetFingerprinting(true);
+}
+
+
+Comparison::~Comparison()
+{
+	// the sequences refer to the texts
+	fSequences.Clear();
+}
+
+
+/*
+ *	Loads both files and interns their lines. Throws the exceptions of
+ *	LineSeparatedText::Load().
+ */
+void
+Comparison::Load(const char* path0, const char* path1)
+{
+	fSequences.Clear();
+	fOperations.clear();
+
+	fTexts[0].Load(path0, fPool);
+	fTexts[1].Load(path1, fPool);
+	fSequences.Assign(0, fTexts[0]);
+	fSequences.Assign(1, fTexts[1]);
+}
+
+
+bool
+Comparison::IsIdentical() const
+{
+	int length = fSequences.GetLength(0);
+	if (length != fSequences.GetLength(1))
+		return false;
+
+	return length == 0
+		|| memcmp(fSequences.GetIDs(0), fSequences.GetIDs(1), length * sizeof(uint32_t)) == 0;
+}
+
+
+/*
+ *	Runs the comparison of the loaded texts, without a time limit, so the
+ *	script is as short as the algorithm can make it. With a sink, the script
+ *	goes there and GetOperations() stays empty.
+ */
+void
+Comparison::Detect(DiffOperationSink* sink)
+{
+	fOperations.clear();
+
+	DiffEngine* diffEngine = DiffEngine::Create(fAlgorithm, fPool);
+	try {
+		diffEngine->SetSink(sink);
+		diffEngine->Detect(&fSequences);
+
+		const DiffOperation* operation;
+		int index;
+		for (index = 0; (operation = diffEngine->GetOperationAt(index)) != NULL; index++)
+			fOperations.push_back(*operation);
+	} catch (...) {
+		delete diffEngine;
+		throw;
+	}
+	delete diffEngine;
+}
+
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef COMPARISON_H
+#define COMPARISON_H
+
+#include <vector>
+
+#include "DiffEngine.h"
+#include "LineInterner.h"
+#include "LineSeparatedText.h"
+
+class ThreadPool;
+
+
+// the exit status of diff(1)
+enum {
+	EXIT_SAME = 0,
+	EXIT_DIFFERENT = 1,
+	EXIT_TROUBLE = 2,
+};
+
+
+/*
+ *	Two files compared line by line, without any user interface: the texts,
+ *	their interned lines and the edit script.
+ */
+class Comparison {
+public:
+	typedef std::vector<DiffOperation>	OperationVector;
+
+						Comparison(ThreadPool* pool = NULL,
+							diff_algorithm algorithm = DIFF_ALGORITHM_NP);
+						~Comparison();
+
+			void		Load(const char* path0, const char* path1);
+			bool		IsIdentical() const;
+			void		Detect(DiffOperationSink* sink = NULL);
+
+	const LineSeparatedText&	GetText(int seqNo) const { return fTexts[seqNo]; }
+	const OperationVector&	GetOperations() const { return fOperations; }
+
+private:
+			ThreadPool*	fPool;
+		diff_algorithm	fAlgorithm;
+	LineSeparatedText	fTexts[2];
+		LineInterner	fInterner;
+	InternedSequences	fSequences;
+	OperationVector		fOperations;
+};
+
+
+
+/*
+ *	Counts the lines an edit script removes from the first file and adds
+ *	from the second one, without keeping the script.
+ */
+class LineCounter : public DiffOperationSink {
+public:
+						LineCounter() : fRemoved(0), fAdded(0) {}
+
+	virtual	void		AddOperation(const DiffOperation& operation)
+						{
+							if (operation.op == DiffOperation::NotChanged)
+								return;
+							fRemoved += operation.count0;
+							fAdded += operation.count1;
+						}
+
+			int			CountRemoved() const { return fRemoved; }
+			int			CountAdded() const { return fAdded; }
+
+private:
+			int			fRemoved;
+			int			fAdded;
+};
+
+#endif // COMPARISON_H
@@ -0,0 +1,272 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#include "DiffOutput.h"
+
+#include <algorithm>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "Comparison.h"
+#include "Exception.h"
+
+
+static const size_t kBufferSize = 64 * 1024;
+
+
+OutputBuffer::OutputBuffer(int fd)
+{
+	fFD = fd;
+	fLength = 0;
+	fError = 0;
+	fBuffer = static_cast<char*>(malloc(kBufferSize));
+	if (fBuffer == NULL)
+		MemoryException::Throw();
+}
+
+
+OutputBuffer::~OutputBuffer()
+{
+	Flush();
+	free(fBuffer);
+}
+
+
+void
+OutputBuffer::Write(const char* data, size_t length)
+{
+	if (fLength + length > kBufferSize) {
+		Flush();
+		if (length > kBufferSize) {
+			// too long to be worth copying
+			fLength = 0;
+			while (length > 0 && fError == 0) {
+				ssize_t written = write(fFD, data, length);
+				if (written < 0) {
+					if (errno != EINTR)
+						fError = errno;
+					continue;
+				}
+				data += written;
+				length -= written;
+			}
+			return;
+		}
+	}
+	memcpy(fBuffer + fLength, data, length);
+	fLength += length;
+}
+
+
+void
+OutputBuffer::WriteNumber(int number)
+{
+	char string[16];
+	Write(string, snprintf(string, sizeof(string), "%d", number));
+}
+
+
+/*
+ *	Writes out what is buffered. Returns false if any write has failed.
+ */
+bool
+OutputBuffer::Flush()
+{
+	size_t offset = 0;
+	while (offset < fLength && fError == 0) {
+		ssize_t written = write(fFD, fBuffer + offset, fLength - offset);
+		if (written < 0) {
+			if (errno != EINTR)
+				fError = errno;
+			continue;
+		}
+		offset += written;
+	}
+	fLength = 0;
+	return fError == 0;
+}
+
+
+// #pragma mark -
+
+
+/*
+ *	Writes a line with its break, as diff(1) does: a lone CR becomes a line
+ *	feed, and a last line without any break is marked as such.
+ */
+static void
+write_line(OutputBuffer& output, const char* prefix, const LineSeparatedText& text,
+	int index)
+{
+	Substring line = text.GetLineAt(index);
+	output.Write(prefix);
+	output.Write(line.Begin(), line.Length());
+
+	char last = line.End()[-1];
+	if (last == '\r')
+		output.Write("\n");
+	else if (last != '\n')
+		output.Write("\n\\ No newline at end of file\n");
+}
+
+
+static void
+write_lines(OutputBuffer& output, const char* prefix, const LineSeparatedText& text,
+	int from, int count)
+{
+	int index;
+	for (index = from; index < from + count; index++)
+		write_line(output, prefix, text, index);
+}
+
+
+/*
+ *	Writes the lines from..from+count as 1-based "first,last", or the line
+ *	before them if there are none.
+ */
+static void
+write_normal_range(OutputBuffer& output, int from, int count)
+{
+	if (count == 0) {
+		output.WriteNumber(from);
+		return;
+	}
+
+	output.WriteNumber(from + 1);
+	if (count > 1) {
+		output.Write(",");
+		output.WriteNumber(from + count);
+	}
+}
+
+
+/*
+ *	Writes the lines from..from+count as 1-based "first,count"; the count is
+ *	left out if it is 1, an empty range names the line before it.
+ */
+static void
+write_unified_range(OutputBuffer& output, int from, int count)
+{
+	output.WriteNumber(count == 0 ? from : from + 1);
+	if (count != 1) {
+		output.Write(",");
+		output.WriteNumber(count);
+	}
+}
+
+
+void
+WriteNormalDiff(OutputBuffer& output, const Comparison& comparison)
+{
+	const LineSeparatedText& text0 = comparison.GetText(0);
+	const LineSeparatedText& text1 = comparison.GetText(1);
+	const Comparison::OperationVector& operations = comparison.GetOperations();
+
+	Comparison::OperationVector::const_iterator iterator;
+	for (iterator = operations.begin(); iterator != operations.end(); iterator++) {
+		const DiffOperation& operation = *iterator;
+		const char* command;
+		switch (operation.op) {
+			case DiffOperation::Inserted:
+				command = "a";
+				break;
+			case DiffOperation::Deleted:
+				command = "d";
+				break;
+			case DiffOperation::Modified:
+				command = "c";
+				break;
+			default:
+				continue;
+		}
+
+		write_normal_range(output, operation.from0, operation.count0);
+		output.Write(command);
+		write_normal_range(output, operation.from1, operation.count1);
+		output.Write("\n");
+
+		write_lines(output, "< ", text0, operation.from0, operation.count0);
+		if (operation.op == DiffOperation::Modified)
+			output.Write("---\n");
+		write_lines(output, "> ", text1, operation.from1, operation.count1);
+	}
+}
+
+
+/*
+ *	Writes the hunks of a unified diff. Changes are joined into one hunk if
+ *	no more than twice the context lies unchanged between them.
+ */
+void
+WriteUnifiedDiff(OutputBuffer& output, const Comparison& comparison,
+	const char* label0, const char* label1, int contextLines)
+{
+	const LineSeparatedText& text0 = comparison.GetText(0);
+	const LineSeparatedText& text1 = comparison.GetText(1);
+	const Comparison::OperationVector& operations = comparison.GetOperations();
+	int count = operations.size();
+
+	output.Write("--- ");
+	output.Write(label0);
+	output.Write("\n+++ ");
+	output.Write(label1);
+	output.Write("\n");
+
+	int first = 0;
+	while (first < count) {
+		if (operations[first].op == DiffOperation::NotChanged) {
+			first++;
+			continue;
+		}
+
+		int last = first;
+		int next;
+		for (next = first + 1; next < count; next++) {
+			const DiffOperation& operation = operations[next];
+			if (operation.op != DiffOperation::NotChanged)
+				last = next;
+			else if (next + 1 == count || operation.count0 > 2 * contextLines)
+				break;
+		}
+
+		int leading = 0;
+		if (first > 0 && operations[first - 1].op == DiffOperation::NotChanged)
+			leading = std::min(contextLines, operations[first - 1].count0);
+		int trailing = 0;
+		if (last + 1 < count && operations[last + 1].op == DiffOperation::NotChanged)
+			trailing = std::min(contextLines, operations[last + 1].count0);
+
+		const DiffOperation& firstOperation = operations[first];
+		const DiffOperation& lastOperation = operations[last];
+		int begin0 = firstOperation.from0 - leading;
+		int begin1 = firstOperation.from1 - leading;
+		int end0 = lastOperation.from0 + lastOperation.count0 + trailing;
+		int end1 = lastOperation.from1 + lastOperation.count1 + trailing;
+
+		output.Write("@@ -");
+		write_unified_range(output, begin0, end0 - begin0);
+		output.Write(" +");
+		write_unified_range(output, begin1, end1 - begin1);
+		output.Write(" @@\n");
+
+		write_lines(output, " ", text0, begin0, leading);
+		int index;
+		for (index = first; index <= last; index++) {
+			const DiffOperation& operation = operations[index];
+			if (operation.op == DiffOperation::NotChanged) {
+				write_lines(output, " ", text0, operation.from0, operation.count0);
+				continue;
+			}
+			write_lines(output, "-", text0, operation.from0, operation.count0);
+			write_lines(output, "+", text1, operation.from1, operation.count1);
+		}
+		write_lines(output, " ", text0, end0 - trailing, trailing);
+
+		first = last + 1;
+	}
+}
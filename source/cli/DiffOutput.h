@@ -0,0 +1,44 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+#ifndef DIFFOUTPUT_H
+#define DIFFOUTPUT_H
+
+#include <stddef.h>
+#include <string.h>
+
+class Comparison;
+
+
+/*
+ *	Buffered output to a file descriptor, with write(2) and nothing else in
+ *	between. The first error is kept; writes after it are dropped.
+ */
+class OutputBuffer {
+public:
+						OutputBuffer(int fd);
+						~OutputBuffer();
+
+			void		Write(const char* data, size_t length);
+			void		Write(const char* string)
+							{ Write(string, strlen(string)); }
+			void		WriteNumber(int number);
+
+			bool		Flush();
+			int			GetError() const { return fError; }
+
+private:
+			int			fFD;
+			char*		fBuffer;
+			size_t		fLength;
+			int			fError;		//< errno of the first failed write
+};
+
+
+void	WriteNormalDiff(OutputBuffer& output, const Comparison& comparison);
+void	WriteUnifiedDiff(OutputBuffer& output, const Comparison& comparison,
+			const char* label0, const char* label1, int contextLines);
+
+#endif // DIFFOUTPUT_H
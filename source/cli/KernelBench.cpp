@@ -0,0 +1,243 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+
+/*
+ *	kernelbench: throughput of the SIMD kernels against the plain loops they
+ *	replace, on synthetic input. Built by "make bench", never installed.
+ *
+ *	Usage: kernelbench [megabytes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "SimdKernels.h"
+
+
+static const int kRepeatCount = 5;
+
+// line IDs per file in the mismatch benchmark
+static const size_t kIDCount = 64 * 1024;
+
+
+static double
+current_seconds()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+// the loop _SplitBuffer() ran before FindLineBreak()
+static const char*
+find_line_break_loop(const char* begin, const char* end)
+{
+	const char* ptr = begin;
+	while (ptr < end && *ptr != '\n' && *ptr != '\r')
+		ptr++;
+	return ptr;
+}
+
+
+// the loop NPDiff used to extend a snake before CountEqualPrefix()
+static size_t
+count_equal_prefix_loop(const uint32_t* a, const uint32_t* b, size_t count)
+{
+	size_t index = 0;
+	while (index < count && a[index] == b[index])
+		index++;
+	return index;
+}
+
+
+typedef const char* (*find_line_break_func)(const char* begin, const char* end);
+typedef size_t (*count_equal_func)(const uint32_t* a, const uint32_t* b, size_t count);
+
+
+/*
+ *	Walks from break to break over the whole buffer, as the split does, and
+ *	returns the best time of a few runs. The number of breaks goes to
+ *	*breakCount, so that both versions can be checked against each other.
+ */
+static double
+time_line_breaks(find_line_break_func find, const char* buffer, size_t size,
+	size_t* breakCount)
+{
+	double best = 0;
+	int repeat;
+	for (repeat = 0; repeat < kRepeatCount; repeat++) {
+		double start = current_seconds();
+		const char* end = buffer + size;
+		const char* ptr = buffer;
+		size_t count = 0;
+		while ((ptr = find(ptr, end)) < end) {
+			count++;
+			ptr++;
+		}
+		double elapsed = current_seconds() - start;
+		if (repeat == 0 || elapsed < best)
+			best = elapsed;
+		*breakCount = count;
+	}
+	return best;
+}
+
+
+static bool
+bench_line_breaks(size_t size)
+{
+	char* buffer = static_cast<char*>(malloc(size));
+	if (buffer == NULL)
+		return false;
+
+	printf("FindLineBreak, %zu MB of text (MB/s):\n", size >> 20);
+	printf("%12s %12s %12s %8s\n", "line length", "loop", "kernel", "speedup");
+
+	static const size_t kLineLengths[] = { 8, 40, 80, 200, 1000 };
+	bool succeeded = true;
+	size_t index;
+	for (index = 0; index < sizeof(kLineLengths) / sizeof(kLineLengths[0]); index++) {
+		// lines of about the given length, with some CR + LF endings
+		srand(1);
+		size_t length = kLineLengths[index];
+		size_t offset;
+		for (offset = 0; offset < size; offset++)
+			buffer[offset] = 'a' + offset % 26;
+		for (offset = rand() % length; offset < size; offset += 1 + rand() % (2 * length)) {
+			if (rand() % 4 == 0 && offset + 1 < size)
+				buffer[offset++] = '\r';
+			buffer[offset] = '\n';
+		}
+
+		size_t loopBreaks;
+		size_t kernelBreaks;
+		double loopTime = time_line_breaks(find_line_break_loop, buffer, size, &loopBreaks);
+		double kernelTime = time_line_breaks(FindLineBreak, buffer, size, &kernelBreaks);
+		if (loopBreaks != kernelBreaks) {
+			fprintf(stderr, "kernelbench: FindLineBreak found %zu breaks instead of %zu\n",
+				kernelBreaks, loopBreaks);
+			succeeded = false;
+		}
+
+		double megabytes = size / 1e6;
+		printf("%12zu %12.0f %12.0f %7.2fx\n", length, megabytes / loopTime,
+			megabytes / kernelTime, loopTime / kernelTime);
+	}
+
+	free(buffer);
+	return succeeded;
+}
+
+
+/*
+ *	Extends snakes over the whole arrays, one run of equal IDs after the
+ *	other, as the O(NP) search does on unchanged lines, passCount times.
+ *	Returns the best time of a few runs, and the number of runs of equal IDs
+ *	in *runCount.
+ */
+static double
+time_equal_runs(count_equal_func countEqual, const uint32_t* a, const uint32_t* b,
+	size_t count, size_t passCount, size_t* runCount)
+{
+	double best = 0;
+	int repeat;
+	for (repeat = 0; repeat < kRepeatCount; repeat++) {
+		double start = current_seconds();
+		size_t runs = 0;
+		size_t pass;
+		for (pass = 0; pass < passCount; pass++) {
+			size_t position = 0;
+			while (position < count) {
+				position += countEqual(a + position, b + position, count - position) + 1;
+				runs++;
+			}
+		}
+		double elapsed = current_seconds() - start;
+		if (repeat == 0 || elapsed < best)
+			best = elapsed;
+		*runCount = runs;
+	}
+	return best;
+}
+
+
+static bool
+bench_equal_runs(size_t size)
+{
+	// the IDs of both files stay in the cache, like the part of the
+	// sequences a search is working on
+	size_t count = kIDCount;
+	size_t passCount = size / (kIDCount * sizeof(uint32_t));
+	if (passCount == 0)
+		passCount = 1;
+	uint32_t* a = static_cast<uint32_t*>(malloc(count * sizeof(uint32_t)));
+	uint32_t* b = static_cast<uint32_t*>(malloc(count * sizeof(uint32_t)));
+	if (a == NULL || b == NULL) {
+		free(a);
+		free(b);
+		return false;
+	}
+
+	printf("CountEqualPrefix, %zu x %zu K line IDs (M lines/s):\n", passCount,
+		count >> 10);
+	printf("%12s %12s %12s %8s\n", "run length", "loop", "kernel", "speedup");
+
+	static const size_t kRunLengths[] = { 4, 16, 64, 1024, 16384 };
+	bool succeeded = true;
+	size_t index;
+	for (index = 0; index < sizeof(kRunLengths) / sizeof(kRunLengths[0]); index++) {
+		// unchanged runs of the given length, each ended by a changed line
+		size_t length = kRunLengths[index];
+		size_t position;
+		for (position = 0; position < count; position++) {
+			a[position] = position;
+			b[position] = (position % (length + 1) == length) ? ~position : position;
+		}
+
+		size_t loopRuns;
+		size_t kernelRuns;
+		double loopTime = time_equal_runs(count_equal_prefix_loop, a, b, count, passCount,
+			&loopRuns);
+		double kernelTime = time_equal_runs(CountEqualPrefix, a, b, count, passCount,
+			&kernelRuns);
+		if (loopRuns != kernelRuns) {
+			fprintf(stderr, "kernelbench: CountEqualPrefix found %zu runs instead of %zu\n",
+				kernelRuns, loopRuns);
+			succeeded = false;
+		}
+
+		double millions = count * passCount / 1e6;
+		printf("%12zu %12.0f %12.0f %7.2fx\n", length, millions / loopTime,
+			millions / kernelTime, loopTime / kernelTime);
+	}
+
+	free(a);
+	free(b);
+	return succeeded;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	size_t megabytes = 256;
+	if (argc > 1)
+		megabytes = strtoul(argv[1], NULL, 10);
+	if (megabytes == 0) {
+		fprintf(stderr, "Usage: kernelbench [megabytes]\n");
+		return 2;
+	}
+
+	printf("kernels: %s\n\n", GetSimdKernelName());
+	bool succeeded = bench_line_breaks(megabytes << 20);
+	printf("\n");
+	if (!bench_equal_runs(megabytes << 20))
+		succeeded = false;
+	return succeeded ? 0 : 1;
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+
+/*
+ *	pooltest: loads the same large files from several pool tasks at once,
+ *	the way the windows share texts through the TextCache: the first task
+ *	to ask for a file loads it, the others block until it is loaded. The
+ *	load splits on the same pool, and must never end up waiting for itself.
+ *	Built and run by "make check"; a deadlock is ended by an alarm.
+ *
+ *	Usage: pooltest [rounds]
+ */
+
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <string.h>
+#include <unistd.h>
+
+#include <pthread.h>
+
+#include "Exception.h"
+#include "LineSeparatedText.h"
+#include "ThreadPool.h"
+
+
+// above the size LineSeparatedText splits in parallel
+static const size_t kFileSize = 20 * 1024 * 1024;
+
+static const int kThreadCount = 4;
+static const int kJobCount = 4;
+
+// the longest a round may take before it counts as a deadlock
+static const unsigned kRoundTimeout = 60;	// seconds
+
+
+/*
+ *	The blocking part of TextCache::Acquire(), without node_refs and
+ *	versions: texts are looked up by path, and loaded once.
+ */
+class SharedTexts {
+public:
+	SharedTexts()
+	{
+		pthread_mutex_init(&fLock, NULL);
+		pthread_cond_init(&fLoaded, NULL);
+	}
+
+	~SharedTexts()
+	{
+		EntryMap::iterator iterator;
+		for (iterator = fEntries.begin(); iterator != fEntries.end(); iterator++)
+			delete iterator->second;
+
+		pthread_cond_destroy(&fLoaded);
+		pthread_mutex_destroy(&fLock);
+	}
+
+	const LineSeparatedText* Acquire(const std::string& path, ThreadPool* pool)
+	{
+		pthread_mutex_lock(&fLock);
+		EntryMap::iterator found = fEntries.find(path);
+		if (found != fEntries.end()) {
+			Entry* entry = found->second;
+			while (entry->isLoading)
+				pthread_cond_wait(&fLoaded, &fLock);
+			pthread_mutex_unlock(&fLock);
+			return &entry->text;
+		}
+
+		Entry* entry = new Entry;
+		entry->isLoading = true;
+		fEntries[path] = entry;
+		pthread_mutex_unlock(&fLock);
+
+		try {
+			entry->text.Load(path.c_str(), pool);
+		} catch (Exception* ex) {
+			ex->Delete();
+		}
+
+		pthread_mutex_lock(&fLock);
+		entry->isLoading = false;
+		pthread_cond_broadcast(&fLoaded);
+		pthread_mutex_unlock(&fLock);
+		return &entry->text;
+	}
+
+private:
+	struct Entry {
+		LineSeparatedText	text;
+		bool				isLoading;
+	};
+	typedef std::map<std::string, Entry*>	EntryMap;
+
+	EntryMap			fEntries;
+	pthread_mutex_t		fLock;
+	pthread_cond_t		fLoaded;
+};
+
+
+// loads one side, like DiffView's LoadTask
+class LoadTask : public PoolTask {
+public:
+	LoadTask(SharedTexts* texts, const std::string& path, ThreadPool* pool)
+		:
+		fTexts(texts),
+		fPath(path),
+		fPool(pool),
+		fLineCount(-1)
+	{
+	}
+
+	virtual void Run()
+	{
+		fLineCount = fTexts->Acquire(fPath, fPool)->GetLineCount();
+	}
+
+	SharedTexts*		fTexts;
+	std::string			fPath;
+	ThreadPool*			fPool;
+	int					fLineCount;
+};
+
+
+// compares two files, like the job of a window: both sides load at once
+class CompareJob : public PoolTask {
+public:
+	CompareJob(SharedTexts* texts, const std::string& path0,
+			const std::string& path1, ThreadPool* pool)
+		:
+		fLeft(texts, path0, pool),
+		fRight(texts, path1, pool),
+		fPool(pool)
+	{
+	}
+
+	virtual void Run()
+	{
+		TaskGroup group;
+		fPool->Submit(&fLeft, &group);
+		fPool->Submit(&fRight, &group);
+		fPool->Wait(&group);
+	}
+
+	LoadTask			fLeft;
+	LoadTask			fRight;
+	ThreadPool*			fPool;
+};
+
+
+static bool
+write_file(const char* path, char lineChar)
+{
+	FILE* file = fopen(path, "w");
+	if (file == NULL)
+		return false;
+
+	char line[64];
+	memset(line, lineChar, sizeof(line) - 1);
+	line[sizeof(line) - 1] = '\n';
+	size_t written;
+	for (written = 0; written < kFileSize; written += sizeof(line))
+		fwrite(line, 1, sizeof(line), file);
+	return fclose(file) == 0;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int roundCount = 20;
+	if (argc > 1)
+		roundCount = atoi(argv[1]);
+	if (roundCount <= 0) {
+		fprintf(stderr, "Usage: pooltest [rounds]\n");
+		return 2;
+	}
+
+	char paths[2][32];
+	int index;
+	for (index = 0; index < 2; index++) {
+		snprintf(paths[index], sizeof(paths[index]), "/tmp/pooltest.%d.%d",
+			static_cast<int>(getpid()), index);
+		if (!write_file(paths[index], 'a' + index)) {
+			fprintf(stderr, "pooltest: cannot write %s\n", paths[index]);
+			return 2;
+		}
+	}
+	int expectedLines = kFileSize / 64;
+
+	bool succeeded = true;
+	ThreadPool pool(kThreadCount);
+	int round;
+	for (round = 0; round < roundCount && succeeded; round++) {
+		alarm(kRoundTimeout);
+
+		// half of the jobs compare the files the other way round
+		SharedTexts texts;
+		CompareJob* jobs[kJobCount];
+		TaskGroup group;
+		for (index = 0; index < kJobCount; index++) {
+			jobs[index] = new CompareJob(&texts, paths[index % 2], paths[1 - index % 2],
+				&pool);
+			pool.SubmitJob(jobs[index], &group);
+		}
+		group.Wait();
+
+		for (index = 0; index < kJobCount; index++) {
+			if (jobs[index]->fLeft.fLineCount != expectedLines
+				|| jobs[index]->fRight.fLineCount != expectedLines) {
+				fprintf(stderr, "pooltest: round %d: %d and %d lines instead of %d\n",
+					round, jobs[index]->fLeft.fLineCount,
+					jobs[index]->fRight.fLineCount, expectedLines);
+				succeeded = false;
+			}
+			delete jobs[index];
+		}
+	}
+	alarm(0);
+
+	for (index = 0; index < 2; index++)
+		unlink(paths[index]);
+
+	if (succeeded)
+		printf("pooltest: %d rounds passed\n", roundCount);
+	return succeeded ? 0 : 1;
+}
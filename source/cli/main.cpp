@@ -0,0 +1,278 @@
+/*
+ * Copyright 2026, HaikuArchives Team
+ * Distributed under the terms of the MIT License.
+ *
+ */
+
+/*
+ *	ponpokodiff: the comparison of PonpokoDiff on the command line, for
+ *	scripts and batch jobs. It needs nothing but POSIX, and builds on Linux
+ *	as well as on Haiku.
+ *
+ *	The exit status is the one of diff(1): 0 if the files are the same, 1 if
+ *	they differ and 2 on trouble.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Batch.h"
+#include "Comparison.h"
+#include "DiffOutput.h"
+#include "Exception.h"
+#include "ExceptionCode.h"
+#include "ThreadPool.h"
+
+
+static const char* kProgramName = "ponpokodiff";
+
+
+static void
+print_usage(FILE* file)
+{
+	fprintf(file,
+		"Usage: %s [options] file1 file2\n"
+		"       %s [options] -r directory1 directory2\n"
+		"       %s [options] -b manifest\n"
+		"Compares two text files line by line; '-' reads standard input.\n"
+		"\n"
+		"  -u            output a unified diff with 3 lines of context\n"
+		"  -U lines      output a unified diff with the given context\n"
+		"  -q            only tell whether the files differ\n"
+		"  -r            compare the files below two directories\n"
+		"  -b manifest   compare the pairs of files listed in manifest, one\n"
+		"                pair per line separated by a tab; '-' reads them from\n"
+		"                standard input\n"
+		"  -a algorithm  np (default, minimal), patience, histogram or parallel\n"
+		"  -j threads    number of threads to use, 0 for one per CPU\n"
+		"  -h            show this help\n"
+		"\n"
+		"With -r or -b, the files are compared in parallel and a report is\n"
+		"written with one line per pair, in order:\n"
+		"  status  removed  added  milliseconds  file1  file2  [reason]\n"
+		"separated by tabs, with status one of same, differ, only or error.\n"
+		"-q leaves out the pairs that are the same.\n",
+		kProgramName, kProgramName, kProgramName);
+}
+
+
+static bool
+parse_number(const char* string, int* number)
+{
+	char* end;
+	errno = 0;
+	long value = strtol(string, &end, 10);
+	if (errno != 0 || end == string || *end != '\0' || value < 0 || value > 1 << 20)
+		return false;
+
+	*number = value;
+	return true;
+}
+
+
+/*
+ *	Returns the header line of a unified diff for path: the name as given,
+ *	and the modification time if there is one.
+ */
+static std::string
+make_label(const char* name, const char* path)
+{
+	std::string label(name);
+
+	struct stat st;
+	struct tm local;
+	if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)
+		|| localtime_r(&st.st_mtime, &local) == NULL)
+		return label;
+
+	char date[64];
+	char zone[16];
+	strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &local);
+	strftime(zone, sizeof(zone), "%z", &local);
+
+	char string[128];
+	snprintf(string, sizeof(string), "\t%s.%09ld %s", date,
+		static_cast<long>(st.st_mtim.tv_nsec), zone);
+	label += string;
+	return label;
+}
+
+
+static void
+report_exception(Exception* ex)
+{
+	switch (ex->GetCode()) {
+		case EXCEPTION_MEMORY:
+			fprintf(stderr, "%s: %s\n", kProgramName, strerror(ENOMEM));
+			break;
+
+		case EXCEPTION_FILE_OPEN:
+		case EXCEPTION_FILE_READ:
+		{
+			FileException* fileException = static_cast<FileException*>(ex);
+			int status = fileException->GetStatus();
+			fprintf(stderr, "%s: %s: %s\n", kProgramName, fileException->GetPath(),
+				strerror(status != 0 ? status : EIO));
+			break;
+		}
+
+		default:
+			fprintf(stderr, "%s: the comparison has failed\n", kProgramName);
+			break;
+	}
+}
+
+
+/*
+ *	Compares the pairs of the manifest, or those below two directories, and
+ *	writes the report of the batch.
+ */
+static int
+run_batch(const char* manifest, char** roots, int threadCount,
+	diff_algorithm algorithm, bool onlyChanges)
+{
+	ThreadPool pool(threadCount);
+	Batch batch(&pool, algorithm);
+	batch.SetOnlyChanges(onlyChanges);
+	try {
+		if (manifest != NULL)
+			batch.AddManifest(manifest);
+		else
+			batch.AddDirectories(roots[0], roots[1]);
+
+		OutputBuffer output(STDOUT_FILENO);
+		int status = batch.Run(output);
+		if (output.GetError() != 0) {
+			fprintf(stderr, "%s: standard output: %s\n", kProgramName,
+				strerror(output.GetError()));
+			return EXIT_TROUBLE;
+		}
+		return status;
+	} catch (Exception* ex) {
+		report_exception(ex);
+		ex->Delete();
+		return EXIT_TROUBLE;
+	}
+}
+
+
+int
+main(int argc, char** argv)
+{
+	bool quiet = false;
+	int contextLines = -1;	// normal output
+	int threadCount = 0;
+	diff_algorithm algorithm = DIFF_ALGORITHM_NP;
+	bool recursive = false;
+	const char* manifest = NULL;
+
+	int option;
+	while ((option = getopt(argc, argv, "uU:qrb:a:j:h")) != -1) {
+		switch (option) {
+			case 'u':
+				contextLines = 3;
+				break;
+			case 'U':
+				if (!parse_number(optarg, &contextLines)) {
+					fprintf(stderr, "%s: invalid context length '%s'\n", kProgramName,
+						optarg);
+					return EXIT_TROUBLE;
+				}
+				break;
+			case 'q':
+				quiet = true;
+				break;
+			case 'r':
+				recursive = true;
+				break;
+			case 'b':
+				manifest = optarg;
+				break;
+			case 'a':
+				if (strcmp(optarg, "np") == 0)
+					algorithm = DIFF_ALGORITHM_NP;
+				else if (strcmp(optarg, "patience") == 0)
+					algorithm = DIFF_ALGORITHM_PATIENCE;
+				else if (strcmp(optarg, "histogram") == 0)
+					algorithm = DIFF_ALGORITHM_HISTOGRAM;
+				else if (strcmp(optarg, "parallel") == 0)
+					algorithm = DIFF_ALGORITHM_PARALLEL;
+				else {
+					fprintf(stderr, "%s: unknown algorithm '%s'\n", kProgramName, optarg);
+					return EXIT_TROUBLE;
+				}
+				break;
+			case 'j':
+				if (!parse_number(optarg, &threadCount)) {
+					fprintf(stderr, "%s: invalid number of threads '%s'\n", kProgramName,
+						optarg);
+					return EXIT_TROUBLE;
+				}
+				break;
+			case 'h':
+				print_usage(stdout);
+				return EXIT_SAME;
+			default:
+				print_usage(stderr);
+				return EXIT_TROUBLE;
+		}
+	}
+	if (argc - optind != (manifest != NULL ? 0 : 2)
+		|| (recursive && manifest != NULL)) {
+		print_usage(stderr);
+		return EXIT_TROUBLE;
+	}
+	if ((recursive || manifest != NULL) && contextLines >= 0) {
+		fprintf(stderr, "%s: a batch only reports, it writes no diffs\n", kProgramName);
+		return EXIT_TROUBLE;
+	}
+
+	if (recursive || manifest != NULL)
+		return run_batch(manifest, argv + optind, threadCount, algorithm, quiet);
+
+	const char* names[2];
+	const char* paths[2];
+	int seqNo;
+	for (seqNo = 0; seqNo < 2; seqNo++) {
+		names[seqNo] = argv[optind + seqNo];
+		paths[seqNo] = strcmp(names[seqNo], "-") == 0 ? "/dev/stdin" : names[seqNo];
+	}
+
+	ThreadPool pool(threadCount);
+	Comparison comparison(&pool, algorithm);
+	try {
+		comparison.Load(paths[0], paths[1]);
+		if (comparison.IsIdentical())
+			return EXIT_SAME;
+		if (quiet) {
+			printf("Files %s and %s differ\n", names[0], names[1]);
+			return EXIT_DIFFERENT;
+		}
+
+		comparison.Detect();
+
+		OutputBuffer output(STDOUT_FILENO);
+		if (contextLines >= 0) {
+			WriteUnifiedDiff(output, comparison, make_label(names[0], paths[0]).c_str(),
+				make_label(names[1], paths[1]).c_str(), contextLines);
+		} else
+			WriteNormalDiff(output, comparison);
+		if (!output.Flush()) {
+			fprintf(stderr, "%s: standard output: %s\n", kProgramName,
+				strerror(output.GetError()));
+			return EXIT_TROUBLE;
+		}
+	} catch (Exception* ex) {
+		report_exception(ex);
+		ex->Delete();
+		return EXIT_TROUBLE;
+	}
+
+	return EXIT_DIFFERENT;
+}